@@ -0,0 +1,179 @@
+/**
+ * @file keygen_benchmark.cpp
+ * @brief Single-thread key generation throughput of the available engines
+ * @author oldnick85
+ * @date 2025
+ *
+ * Usage: keygen_benchmark [SECONDS] [sweep]
+ *
+ * Every case runs for SECONDS (default 2) on one thread and reports keys per
+ * second and the speedup over libsodium. The portable scalar path is also
+ * measured with 1, 2 and 4 keys interleaved and with the kernels of every
+ * x86-64 level the CPU supports, without SIMD or BMI2/ADX, to show what
+ * each of them buys on this CPU. With "sweep" the batch engine is also
+ * measured across base table shapes (window x spacing) in both lookup
+ * modes, to pick the table size that suits a given CPU's caches.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ed25519_keys_generator.h"
+#include "ge25519_base_table.h"
+#include "key_engine.h"
+#include "seed_stream.h"
+
+using yggdrasil_cpp_genkeys::BatchKeyEngine;
+using yggdrasil_cpp_genkeys::Ed25519_KeysGenerator;
+using yggdrasil_cpp_genkeys::GeTableShape;
+using yggdrasil_cpp_genkeys::IsaLevel;
+using yggdrasil_cpp_genkeys::KeyEngine;
+using yggdrasil_cpp_genkeys::KeyEngineInfo;
+using yggdrasil_cpp_genkeys::Keys_t;
+
+namespace
+{
+
+constexpr size_t BATCH_SIZE = 128;
+
+/**
+ * @brief Runs @p step until @p seconds have passed.
+ *
+ * @param step generates a number of keys and returns how many
+ * @return keys per second
+ */
+double Measure(double seconds, const std::function<size_t()>& step)
+{
+    using Clock = std::chrono::steady_clock;
+
+    step();  // warm up tables and buffers
+    size_t keys = 0;
+    const auto start = Clock::now();
+    auto elapsed = std::chrono::duration<double>(0);
+    while (elapsed.count() < seconds) {
+        keys += step();
+        elapsed = Clock::now() - start;
+    }
+    return static_cast<double>(keys) / elapsed.count();
+}
+
+double MeasureBatch(double seconds, const GeTableShape& shape, bool vartime)
+{
+    std::vector<Keys_t> batch(BATCH_SIZE);
+    Ed25519_KeysGenerator generator;
+    generator.SetUnsafeVartime(vartime);
+    generator.SetTableShape(shape);
+    generator.Generate(true);
+    return Measure(seconds, [&generator, &batch] {
+        generator.GenerateBatchPartial(batch);
+        return batch.size();
+    });
+}
+
+double MeasureEngine(double seconds, KeyEngine& engine)
+{
+    std::vector<Keys_t> batch(BATCH_SIZE);
+    yggdrasil_cpp_genkeys::SeedStream seeds;
+    return Measure(seconds, [&seeds, &engine, &batch] {
+        seeds.Fill(batch);
+        engine.GeneratePartial(batch);
+        return batch.size();
+    });
+}
+
+void Report(const std::string& name, double keys_per_second, double baseline)
+{
+    std::println("{:<32} {:>12.0f} keys/s {:>7.2f}x", name, keys_per_second,
+                 keys_per_second / baseline);
+}
+
+std::string CpuModel()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.starts_with("model name")) {
+            return line.substr(line.find(':') + 2);
+        }
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Measures every table shape of the sweep in both lookup modes.
+ */
+void Sweep(double seconds, double baseline)
+{
+    std::println("\n{:>6} {:>7} {:>10} {:>14} {:>14}", "window", "spacing",
+                 "table KiB", "ct keys/s", "vartime keys/s");
+    for (uint window = 4; window <= 8; ++window) {
+        for (const uint spacing : {1U, 2U, 4U}) {
+            const GeTableShape shape{.window = window, .spacing = spacing};
+            const double constant_time = MeasureBatch(seconds, shape, false);
+            const double vartime = MeasureBatch(seconds, shape, true);
+            std::println("{:>6} {:>7} {:>10} {:>8.0f} {:>4.2f}x {:>8.0f} "
+                         "{:>4.2f}x",
+                         window, spacing, shape.Bytes() / 1024, constant_time,
+                         constant_time / baseline, vartime, vartime / baseline);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    const double seconds = (argc > 1) ? std::atof(argv[1]) : 2.0;
+    const bool sweep = (argc > 2) and (std::string_view(argv[2]) == "sweep");
+
+    std::println("CPU: {}", CpuModel());
+
+    Ed25519_KeysGenerator sodium;
+    sodium.Generate(true);
+    const double baseline = Measure(seconds, [&sodium] {
+        sodium.Generate();
+        return size_t{1};
+    });
+    Report("libsodium", baseline, baseline);
+
+    for (const auto& info : yggdrasil_cpp_genkeys::KeyEngines()) {
+        if (info.available()) {
+            Report(std::format("engine {}", info.name),
+                   MeasureEngine(seconds, *info.make({})), baseline);
+        }
+    }
+
+    for (const size_t ways : {1, 2, 4}) {
+        BatchKeyEngine engine({}, false, false, ways);
+        Report(std::format("scalar, {}-way interleave", ways),
+               MeasureEngine(seconds, engine), baseline);
+    }
+
+    const auto top = static_cast<int>(
+        yggdrasil_cpp_genkeys::GetCpuFeatures().isa_level);
+    for (int level = 0; level <= top; ++level) {
+        const auto isa = static_cast<IsaLevel>(level);
+        BatchKeyEngine engine({.isa_level = isa}, false, false);
+        Report(std::format("scalar, {} kernels",
+                           yggdrasil_cpp_genkeys::IsaLevelName(isa)),
+               MeasureEngine(seconds, engine), baseline);
+    }
+
+    const GeTableShape default_shape{};
+    Report("batch, constant time",
+           MeasureBatch(seconds, default_shape, false), baseline);
+    Report("batch, unsafe vartime", MeasureBatch(seconds, default_shape, true),
+           baseline);
+
+    if (sweep) {
+        Sweep(seconds, baseline);
+    }
+
+    return 0;
+}
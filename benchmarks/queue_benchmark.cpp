@@ -0,0 +1,118 @@
+/**
+ * @file queue_benchmark.cpp
+ * @brief Candidate queue throughput under producer contention
+ * @author oldnick85
+ * @date 2025
+ *
+ * Usage: queue_benchmark [PUSHES]
+ *
+ * For 1 to 256 producer threads, every producer pushes PUSHES / producers
+ * candidates (default 2^20 in total) while one consumer drains the queue,
+ * once through ThreadSafeQueue (mutex, std::queue, notify per push) and
+ * once through the lock-free CandidateRing. Reports pushes per second; the
+ * ring drops on overflow like the workers do, so its drop count is shown
+ * next to it.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "candidate.h"
+#include "mpsc_ring.h"
+#include "thread_safe_queue.h"
+#include "worker.h"
+
+using yggdrasil_cpp_genkeys::Candidate;
+using yggdrasil_cpp_genkeys::CandidateRing;
+using yggdrasil_cpp_genkeys::ThreadSafeQueue;
+
+namespace
+{
+
+struct Result
+{
+    double pushes_per_second = 0;
+    uint64_t received = 0;
+};
+
+/**
+ * @brief Runs @p producers threads calling @p push @p per_producer times
+ * each, while the calling thread drains with @p pop until they are done.
+ */
+template <typename Push, typename Pop>
+Result Run(size_t producers, size_t per_producer, Push push, Pop pop)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<size_t> running = producers;
+    std::atomic<bool> go = false;
+    std::vector<std::jthread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            while (not go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            Candidate candidate;
+            candidate.zero_bits = static_cast<uint>(p);
+            for (size_t i = 0; i < per_producer; ++i) {
+                candidate.ipv6_zero_blocks = static_cast<uint>(i);
+                push(candidate);
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    Result result;
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    while (running.load(std::memory_order_acquire) != 0) {
+        if (pop()) {
+            ++result.received;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    while (pop()) {
+        ++result.received;
+    }
+    result.pushes_per_second =
+        static_cast<double>(producers * per_producer) / elapsed.count();
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t pushes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10)
+                                     : size_t{1} << 20U;
+
+    std::println("{:>9} {:>16} {:>16} {:>10}", "producers", "queue pushes/s",
+                 "ring pushes/s", "ring drops");
+    for (size_t producers = 1; producers <= 256; producers *= 2) {
+        const size_t per_producer = std::max<size_t>(pushes / producers, 1);
+
+        ThreadSafeQueue<Candidate> queue;
+        const auto locked = Run(
+            producers, per_producer,
+            [&queue](const Candidate& c) { queue.push_back(c); },
+            [&queue] { return queue.try_pop_front().has_value(); });
+
+        CandidateRing ring;
+        const auto lock_free = Run(
+            producers, per_producer,
+            [&ring](const Candidate& c) { ring.try_push(c); },
+            [&ring] { return ring.try_pop().has_value(); });
+
+        std::println("{:>9} {:>16.0f} {:>16.0f} {:>10}", producers,
+                     locked.pushes_per_second, lock_free.pushes_per_second,
+                     ring.Overflows());
+    }
+
+    return 0;
+}
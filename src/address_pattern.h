@@ -0,0 +1,149 @@
+/**
+ * @file address_pattern.h
+ * @brief Vanity address templates compiled to bit masks
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "bytes.h"
+#include "ipv6_addr.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief An IPv6 address template as a 128-bit mask and value.
+ *
+ * The template is written like an address, with all eight groups, e.g.
+ * `200:dead:beef:0:?:*:*:*`:
+ * - a group of up to four hex digits is zero-padded on the left as usual;
+ * - `?` in a group stands for any hex digit;
+ * - `*` stands for a whole group, and as the last group for all groups
+ *   left, so `200:dead:beef:*` is the same as the example above.
+ *
+ * Matching never touches strings: an address, as two big-endian words, is
+ * masked and compared with the value.
+ */
+struct AddressPattern
+{
+    std::array<uint64_t, 2> mask{};   ///< address bits the template fixes
+    std::array<uint64_t, 2> value{};  ///< their values, zero elsewhere
+
+    /**
+     * @brief Compiles a template.
+     *
+     * @return nullopt if @p text is not a template or no Yggdrasil address
+     *         (prefix 0x02) can match it
+     */
+    static std::optional<AddressPattern> Parse(std::string_view text)
+    {
+        constexpr size_t GROUPS = 8;
+        constexpr size_t DIGITS = 4;
+
+        AddressPattern pattern;
+        size_t group = 0;
+        while (group < GROUPS) {
+            const size_t end = text.find(':');
+            const auto token = text.substr(0, end);
+            const bool last = (end == std::string_view::npos);
+
+            if (token == "*") {
+                group = last ? GROUPS : group + 1;
+            }
+            else {
+                if (token.empty() or (token.size() > DIGITS)) {
+                    return std::nullopt;
+                }
+                uint64_t mask = 0xffff;
+                uint64_t value = 0;
+                for (size_t i = 0; i < token.size(); ++i) {
+                    const auto nibble = 4 * (token.size() - 1 - i);
+                    const auto digit = HexDigit(token[i]);
+                    if (token[i] == '?') {
+                        mask &= ~(uint64_t{0xf} << nibble);
+                    }
+                    else if (digit.has_value()) {
+                        value |= uint64_t{*digit} << nibble;
+                    }
+                    else {
+                        return std::nullopt;
+                    }
+                }
+                const auto shift = 48 - (16 * (group % 4));
+                pattern.mask[group / 4] |= mask << shift;
+                pattern.value[group / 4] |= value << shift;
+                ++group;
+            }
+
+            if (last) {
+                break;
+            }
+            text.remove_prefix(end + 1);
+            if (group == GROUPS) {
+                return std::nullopt;  // more than eight groups
+            }
+        }
+        if (group != GROUPS) {
+            return std::nullopt;
+        }
+
+        constexpr uint64_t PREFIX = uint64_t{0x02} << 56U;
+        constexpr uint64_t PREFIX_MASK = uint64_t{0xff} << 56U;
+        if ((pattern.value[0] & PREFIX_MASK) !=
+            (PREFIX & pattern.mask[0] & PREFIX_MASK)) {
+            return std::nullopt;
+        }
+        return pattern;
+    }
+
+    /**
+     * @brief Whether a key with @p zero_bits leading zero bits can match.
+     *
+     * The second address byte is the leading zero count of the key, so the
+     * template fixes it before any address is derived.
+     */
+    [[nodiscard]] constexpr bool MatchesLeadingZeros(uint zero_bits) const
+    {
+        const auto ones_mask = static_cast<uint8_t>(mask[0] >> 48U);
+        const auto ones_value = static_cast<uint8_t>(value[0] >> 48U);
+        return (static_cast<uint8_t>(zero_bits) & ones_mask) == ones_value;
+    }
+
+    /**
+     * @brief Whether the address @p hi, @p lo (big-endian words) matches.
+     */
+    [[nodiscard]] constexpr bool Matches(uint64_t hi, uint64_t lo) const
+    {
+        return (((hi & mask[0]) ^ value[0]) | ((lo & mask[1]) ^ value[1])) == 0;
+    }
+
+    [[nodiscard]] constexpr bool Matches(const IPv6_Addr& addr) const
+    {
+        return Matches(LoadBigEndian64(addr.bytes.data()),
+                       LoadBigEndian64(addr.bytes.data() + 8));
+    }
+
+   private:
+    static constexpr std::optional<uint8_t> HexDigit(char c)
+    {
+        if ((c >= '0') and (c <= '9')) {
+            return static_cast<uint8_t>(c - '0');
+        }
+        if ((c >= 'a') and (c <= 'f')) {
+            return static_cast<uint8_t>(c - 'a' + 10);
+        }
+        if ((c >= 'A') and (c <= 'F')) {
+            return static_cast<uint8_t>(c - 'A' + 10);
+        }
+        return std::nullopt;
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
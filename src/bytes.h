@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include <span>
 #include <string>
 
@@ -51,6 +55,48 @@ static inline std::array<uint8_t, SIZE> HexToBytes(std::string_view hex)
     return bytes;
 }
 
+/**
+ * @brief Reads 8 bytes at @p bytes as a big-endian integer.
+ *
+ * One load and a byte swap at run time, also usable in constant expressions.
+ */
+constexpr uint64_t LoadBigEndian64(const uint8_t* bytes)
+{
+    if consteval {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value = (value << 8U) | bytes[i];
+        }
+        return value;
+    }
+    else {
+        uint64_t value = 0;
+        std::memcpy(&value, bytes, sizeof(value));
+        if constexpr (std::endian::native == std::endian::little) {
+            value = std::byteswap(value);
+        }
+        return value;
+    }
+}
+
+/**
+ * @brief Writes @p value to the 8 bytes at @p bytes, big-endian.
+ */
+constexpr void StoreBigEndian64(uint8_t* bytes, uint64_t value)
+{
+    if consteval {
+        for (size_t i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<uint8_t>(value >> (56 - (8 * i)));
+        }
+    }
+    else {
+        if constexpr (std::endian::native == std::endian::little) {
+            value = std::byteswap(value);
+        }
+        std::memcpy(bytes, &value, sizeof(value));
+    }
+}
+
 template <size_t SIZE>
 class BaseKey_t
 {
@@ -1,32 +1,71 @@
 #pragma once
 
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <sodium.h>  // libsodium to rebuild the key pair
+#ifdef __cplusplus
+}
+#endif
+
+#include <cassert>
+#include <cstdint>
+
 #include "ed25519_keys.h"
 #include "ipv6_addr.h"
 
 namespace yggdrasil_cpp_genkeys
 {
 
+/**
+ * @brief A scored key, identified by its seed alone.
+ *
+ * Workers score keys in place and only pass these 48 bytes around; the key
+ * pair and the address are rebuilt from the seed by Materialize() when a
+ * winner is printed.
+ */
 struct Candidate
 {
-    Keys_t keys{};
-    IPv6_Addr addr{};
+    Seed_t seed{};
     uint zero_bits = 0;
     uint ipv6_zero_blocks = 0;
+    uint32_t target = 0;         ///< matched template of --pattern-file
+    bool pattern_match = false;  ///< the address matches the template
 
     [[nodiscard]] bool IsBetter(const Candidate& other, bool ipv6_nice) const
+    {
+        return Rank(ipv6_nice) > other.Rank(ipv6_nice);
+    }
+
+    /**
+     * @brief Packs the score into one integer ordered like IsBetter().
+     *
+     * In --ipv6-nice mode zero blocks come first and leading zero bits break
+     * ties, otherwise only leading zero bits count.
+     */
+    [[nodiscard]] uint64_t Rank(bool ipv6_nice) const
     {
         if (ipv6_nice) {
-            if ((ipv6_zero_blocks > other.ipv6_zero_blocks) or
-                ((ipv6_zero_blocks == other.ipv6_zero_blocks) and
-                 (zero_bits > other.zero_bits))) {
-                return true;
-            }
-        }
-        else if (zero_bits > other.zero_bits) {
-            return true;
+            return (static_cast<uint64_t>(ipv6_zero_blocks) << 32U) | zero_bits;
         }
-        return false;
+        return zero_bits;
+    }
+
+    /**
+     * @brief Derives the full key pair of the seed.
+     *
+     * The caller owns the secret key and should wipe it after use.
+     */
+    [[nodiscard]] Keys_t Materialize() const
+    {
+        Keys_t keys;
+        keys.seed = seed;
+        [[maybe_unused]] const auto result = crypto_sign_ed25519_seed_keypair(
+            keys.public_key.data(), keys.secret_key.data(), keys.seed.data());
+        assert(result == 0);
+        return keys;
     }
 };
 
-}  // namespace yggdrasil_cpp_genkeys
\ No newline at end of file
+}  // namespace yggdrasil_cpp_genkeys
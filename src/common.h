@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <string>
 
 namespace yggdrasil_cpp_genkeys
 {
@@ -17,6 +18,16 @@ struct Settings
         0;                 ///< target number of leading zero bits in public key
     bool verbose = false;  ///< verbose output mode
     bool ipv6_nice = false;  ///< search nice-looking address
+    std::string pattern;     ///< address template, empty = none
+    std::string pattern_file;  ///< file of address templates, empty = none
+    std::string engine = "auto";  ///< key engine name, "auto" = calibrate
+    bool unsafe_vartime = false;  ///< variable-time (not constant-time) tables
+    uint table_window = 4;   ///< base table digit width in bits
+    uint table_spacing = 2;  ///< digits sharing one base table row
+    std::string table_cache_dir;  ///< table cache directory, empty = default
+    bool no_table_cache = false;  ///< always compute tables in memory
+    bool no_huge_pages = false;   ///< computed tables on regular pages
+    std::string output_format = "text";  ///< "text" or "json" (NDJSON)
 };
 
 inline std::string add_fraction(uint64_t fraction, int precision)
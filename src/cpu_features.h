@@ -0,0 +1,108 @@
+/**
+ * @file cpu_features.h
+ * @brief Runtime detection of CPU instruction set extensions
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Cache line size of the supported x86-64 and ARMv8 cores
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief x86-64 microarchitecture levels the hot kernels are built for.
+ *
+ * V1 is the baseline every x86-64 CPU has (and the only level elsewhere),
+ * V2 adds SSE4.2/POPCNT, V3 AVX2/BMI2/FMA and V4 AVX-512.
+ */
+enum class IsaLevel : uint8_t
+{
+    V1,
+    V2,
+    V3,
+    V4,
+};
+
+/**
+ * @brief Name of the level as accepted by -march.
+ */
+constexpr std::string_view IsaLevelName(IsaLevel level)
+{
+#if defined(__x86_64__)
+    switch (level) {
+        case IsaLevel::V1:
+            return "x86-64";
+        case IsaLevel::V2:
+            return "x86-64-v2";
+        case IsaLevel::V3:
+            return "x86-64-v3";
+        case IsaLevel::V4:
+            return "x86-64-v4";
+    }
+#endif
+    return (level == IsaLevel::V1) ? "baseline" : "unknown";
+}
+
+/**
+ * @brief Instruction set extensions usable by the hot kernels.
+ *
+ * Kernels that need an extension are compiled with a per-function target
+ * attribute and are only called when the running CPU reports support, so a
+ * single binary works on every x86-64 host.
+ */
+struct CpuFeatures
+{
+    bool avx2 = false;  ///< 256-bit integer SIMD
+    bool bmi2 = false;  ///< mulx, flag-free 64x64->128 bit multiplication
+    bool adx = false;   ///< adcx/adox, two independent carry chains
+    IsaLevel isa_level = IsaLevel::V1;  ///< highest level fully supported
+};
+
+/**
+ * @brief Returns the features of the running CPU, detected once.
+ */
+inline const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures features = [] {
+        CpuFeatures result;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        result.avx2 = __builtin_cpu_supports("avx2") != 0;
+        result.bmi2 = __builtin_cpu_supports("bmi2") != 0;
+        // no __builtin_cpu_supports("adx") in older compilers
+        unsigned int eax = 0;
+        unsigned int ebx = 0;
+        unsigned int ecx = 0;
+        unsigned int edx = 0;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0) {
+            result.adx = (ebx & bit_ADX) != 0;
+        }
+#endif
+#if defined(__x86_64__)
+        if (__builtin_cpu_supports("x86-64-v4") != 0) {
+            result.isa_level = IsaLevel::V4;
+        }
+        else if (__builtin_cpu_supports("x86-64-v3") != 0) {
+            result.isa_level = IsaLevel::V3;
+        }
+        else if (__builtin_cpu_supports("x86-64-v2") != 0) {
+            result.isa_level = IsaLevel::V2;
+        }
+#endif
+        return result;
+    }();
+    return features;
+}
+
+}  // namespace yggdrasil_cpp_genkeys
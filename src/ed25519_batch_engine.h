@@ -0,0 +1,350 @@
+/**
+ * @file ed25519_batch_engine.h
+ * @brief Batched Ed25519 public key derivation with a shared field inversion
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <sodium.h>  // libsodium for memory wiping
+#ifdef __cplusplus
+}
+#endif
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "cpu_features.h"
+#include "ed25519_keys.h"
+#include "ge25519.h"
+#include "ge25519_64.h"
+#include "ge25519_base_table.h"
+#include "ge25519_interleaved.h"
+#include "ge25519_x4.h"
+#include "sha512.h"
+#include "sha512_x4.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Derives Ed25519 key pairs for a whole batch of seeds at once.
+ *
+ * libsodium's crypto_sign_ed25519_seed_keypair() encodes every public key
+ * separately and so pays a full field inversion (~254 squarings) per key.
+ * Here the scalar multiplications of the batch are left in projective form
+ * and all Z coordinates are inverted together with Montgomery's trick, which
+ * costs one inversion plus three multiplications per key.
+ *
+ * On AVX2 hosts seeds are expanded with SHA-512 and multiplied by the base
+ * point four at a time in vector lanes. Otherwise the fixed-shape
+ * Sha512SeedHasher and the scalar multiplication are used, the latter with
+ * mulx/adx 64-bit limb arithmetic on hosts with BMI2 and ADX, or with
+ * two or four keys interleaved in lockstep when SetInterleave() asks so.
+ *
+ * The output is bit-identical to libsodium.
+ */
+class Ed25519_BatchEngine
+{
+   public:
+    Ed25519_BatchEngine() = default;
+    Ed25519_BatchEngine(const Ed25519_BatchEngine&) = delete;
+    Ed25519_BatchEngine& operator=(const Ed25519_BatchEngine&) = delete;
+    Ed25519_BatchEngine(Ed25519_BatchEngine&&) = delete;
+    Ed25519_BatchEngine& operator=(Ed25519_BatchEngine&&) = delete;
+
+    /**
+     * @brief Destructor - securely cleans up intermediate points
+     */
+    ~Ed25519_BatchEngine() { Cleanup(); }
+
+    /**
+     * @brief Fills public and secret keys for every seed of the batch.
+     *
+     * @param batch key sets with the seed already filled in
+     */
+    void Generate(std::span<Keys_t> batch)
+    {
+        GeneratePartial(batch);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Complete(i, batch[i]);
+        }
+    }
+
+    /**
+     * @brief Derives only the y part of every public key of the batch.
+     *
+     * The public key gets little-endian y with bit 255 (the sign of x) clear
+     * and the secret key is left untouched. Every byte a score looks at is
+     * already final, so callers can reject keys here and call Complete()
+     * only for the rare keys that win.
+     *
+     * @param batch key sets with the seed already filled in
+     */
+    void GeneratePartial(std::span<Keys_t> batch)
+    {
+        Reserve(batch.size());
+        HashSeeds(batch);
+        MultiplyBase(batch.size());
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            z_inv_[i] = points_[i].z;
+        }
+        FeBatchInvert(std::span(z_inv_.data(), batch.size()),
+                      std::span(scratch_.data(), batch.size()));
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            GeEncodeY(points_[i], z_inv_[i], batch[i].public_key.bytes);
+        }
+    }
+
+    /**
+     * @brief Finishes a key of the last GeneratePartial() batch.
+     *
+     * Sets the sign of x in the public key and fills the secret key.
+     *
+     * @param index position of the key in the batch
+     * @param keys the same key set that was passed at that position
+     */
+    void Complete(size_t index, Keys_t& keys)
+    {
+        GeEncodeSign(points_[index], z_inv_[index], keys.public_key.bytes);
+        std::ranges::copy(keys.seed.bytes, keys.secret_key.bytes.begin());
+        std::ranges::copy(keys.public_key.bytes,
+                          keys.secret_key.bytes.begin() + Seed_t::Size);
+    }
+
+    /**
+     * @brief Switches to variable-time base table lookups.
+     *
+     * Faster, but the memory access pattern and the running time of the
+     * scalar multiplication depend on the secret scalar. Only for isolated
+     * hosts where timing side channels are not part of the threat model.
+     */
+    void SetUnsafeVartime(bool enable) { unsafe_vartime_ = enable; }
+
+    /**
+     * @brief Selects the base table layout used by the scalar multiplication.
+     *
+     * Tables are shared between engines, the first engine asking for a shape
+     * builds it.
+     */
+    void SetTableShape(const GeTableShape& shape)
+    {
+        table_ = &GetBaseTable(shape);
+    }
+
+    /**
+     * @brief Enables or disables the AVX2 4-way kernels.
+     *
+     * Enabled by default on CPUs with AVX2; requests to enable them on other
+     * CPUs are ignored.
+     */
+    void SetSimd(bool enable) { simd_ = enable and GetCpuFeatures().avx2; }
+
+    /**
+     * @brief Enables or disables the BMI2/ADX scalar field arithmetic.
+     *
+     * Enabled by default on CPUs with both extensions; requests to enable it
+     * on other CPUs are ignored.
+     */
+    void SetMulx(bool enable) { mulx_ = enable and MulxSupported(); }
+
+    /**
+     * @brief Whether the running CPU can use the BMI2/ADX arithmetic.
+     */
+    static bool MulxSupported()
+    {
+#if defined(__x86_64__)
+        return GetCpuFeatures().bmi2 and GetCpuFeatures().adx;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Number of scalar multiplications advanced in lockstep on the
+     * non-SIMD path.
+     *
+     * 2 or 4 interleave the field operations of that many keys in portable
+     * radix 2^51 arithmetic (and take precedence over the BMI2/ADX path);
+     * any other value selects one key at a time.
+     */
+    void SetInterleave(size_t ways)
+    {
+        interleave_ = ((ways == 2) or (ways == GE_MAX_INTERLEAVE)) ? ways : 1;
+    }
+
+   private:
+    const GeBaseTable* table_ = nullptr;          ///< fixed-base table, lazy
+    bool unsafe_vartime_ = false;                 ///< vartime table lookups
+    bool simd_ = GetCpuFeatures().avx2;           ///< AVX2 4-way kernels
+    bool mulx_ = MulxSupported();                 ///< BMI2/ADX scalar path
+    size_t interleave_ = 1;                       ///< keys in lockstep
+
+    std::vector<Sha512Digest> hashes_;  ///< SHA-512 of every seed
+    std::vector<GeP3> points_;          ///< a * B of every key in the batch
+    std::vector<Fe25519> z_inv_;        ///< Z coordinates, inverted in place
+    std::vector<Fe25519> scratch_;      ///< prefix products for inversion
+
+    /**
+     * @brief Computes SHA-512 of every seed of the batch into hashes_.
+     *
+     * Full groups of four go through the AVX2 multi-buffer kernel when simd_
+     * is set, the remainder goes through the scalar seed hasher.
+     */
+    void HashSeeds(std::span<const Keys_t> batch)
+    {
+        size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (simd_) {
+            for (; i + SHA512_X4_LANES <= batch.size(); i += SHA512_X4_LANES) {
+                std::array<const Seed_t*, SHA512_X4_LANES> seeds{};
+                std::array<Sha512Digest*, SHA512_X4_LANES> digests{};
+                for (size_t lane = 0; lane < SHA512_X4_LANES; ++lane) {
+                    seeds[lane] = &batch[i + lane].seed;
+                    digests[lane] = &hashes_[i + lane];
+                }
+                Sha512SeedsX4(seeds, digests);
+            }
+        }
+#endif
+        for (; i < batch.size(); ++i) {
+            Sha512SeedHasher::Hash(batch[i].seed, hashes_[i]);
+        }
+    }
+
+    /**
+     * @brief Computes points_[i] = a_i * B from the seed hashes.
+     *
+     * Groups of four run through the AVX2 4-way engine when simd_ is set, the
+     * remainder through the scalar multiplication: interleave_ keys at a
+     * time, or on 64-bit limbs when mulx_ is set. All of them use the
+     * variable-time lookups when unsafe_vartime_ is set.
+     *
+     * Without SetTableShape() the default table is looked up here, on first
+     * use, so engines given another shape never build it.
+     */
+    void MultiplyBase(size_t size)
+    {
+        if (table_ == nullptr) {
+            table_ = &GetBaseTable();
+        }
+        size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (simd_) {
+            for (; i + GE_X4_LANES <= size; i += GE_X4_LANES) {
+                std::array<std::array<uint8_t, 32>, GE_X4_LANES> scalars{};
+                std::array<std::span<const uint8_t, 32>, GE_X4_LANES> spans{
+                    scalars[0], scalars[1], scalars[2], scalars[3]};
+                std::array<GeP3*, GE_X4_LANES> points{};
+                for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+                    scalars[lane] = SecretScalar(hashes_[i + lane]);
+                    points[lane] = &points_[i + lane];
+                }
+                if (unsafe_vartime_) {
+                    GeScalarMultBaseX4Vartime(spans, points, *table_);
+                }
+                else {
+                    GeScalarMultBaseX4(spans, points, *table_);
+                }
+                sodium_memzero(scalars.data(), sizeof(scalars));
+            }
+        }
+#endif
+        if (interleave_ == GE_MAX_INTERLEAVE) {
+            i = MultiplyBaseInterleaved<GE_MAX_INTERLEAVE>(i, size);
+        }
+        if (interleave_ > 1) {
+            i = MultiplyBaseInterleaved<2>(i, size);
+        }
+        for (; i < size; ++i) {
+            auto scalar = SecretScalar(hashes_[i]);
+            points_[i] = ScalarMultBase(scalar);
+            sodium_memzero(scalar.data(), scalar.size());
+        }
+    }
+
+    /**
+     * @brief Computes points_ in groups of N interleaved keys from @p i on.
+     *
+     * @return index of the first key left over
+     */
+    template <size_t N>
+    size_t MultiplyBaseInterleaved(size_t i, size_t size)
+    {
+        for (; i + N <= size; i += N) {
+            std::array<std::array<uint8_t, 32>, N> scalars{};
+            std::array<GeP3*, N> points{};
+            for (size_t l = 0; l < N; ++l) {
+                scalars[l] = SecretScalar(hashes_[i + l]);
+                points[l] = &points_[i + l];
+            }
+            if (unsafe_vartime_) {
+                GeScalarMultBaseInterleavedVartime(scalars, points, *table_);
+            }
+            else {
+                GeScalarMultBaseInterleaved(scalars, points, *table_);
+            }
+            sodium_memzero(scalars.data(), sizeof(scalars));
+        }
+        return i;
+    }
+
+    /**
+     * @brief Scalar a * B with the arithmetic and lookups selected.
+     */
+    GeP3 ScalarMultBase(std::span<const uint8_t, 32> scalar) const
+    {
+#if defined(__x86_64__)
+        if (mulx_) {
+            return unsafe_vartime_ ? GeScalarMultBase64Vartime(scalar, *table_)
+                                   : GeScalarMultBase64(scalar, *table_);
+        }
+#endif
+        return unsafe_vartime_ ? GeScalarMultBaseVartime(scalar, *table_)
+                               : GeScalarMultBase(scalar, *table_);
+    }
+
+    /**
+     * @brief Clamps the first half of a seed hash into the secret scalar.
+     */
+    static std::array<uint8_t, 32> SecretScalar(const Sha512Digest& hash)
+    {
+        std::array<uint8_t, 32> scalar{};
+        std::copy_n(hash.begin(), scalar.size(), scalar.begin());
+        scalar[0] &= 248;
+        scalar[31] &= 127;
+        scalar[31] |= 64;
+        return scalar;
+    }
+
+    void Reserve(size_t size)
+    {
+        if (points_.size() < size) {
+            Cleanup();
+            hashes_.resize(size);
+            points_.resize(size);
+            z_inv_.resize(size);
+            scratch_.resize(size);
+        }
+    }
+
+    /**
+     * @brief Securely cleans up sensitive data
+     */
+    void Cleanup() noexcept
+    {
+        sodium_memzero(hashes_.data(), hashes_.size() * sizeof(Sha512Digest));
+        sodium_memzero(points_.data(), points_.size() * sizeof(GeP3));
+        sodium_memzero(z_inv_.data(), z_inv_.size() * sizeof(Fe25519));
+        sodium_memzero(scratch_.data(), scratch_.size() * sizeof(Fe25519));
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <array>
+#include <bit>
 #include <cassert>
-#include <vector>
+#include <cstdint>
 
 #include "bytes.h"
 #include "ipv6_addr.h"
@@ -102,75 +103,75 @@ constexpr std::array<uint8_t, 1> GetPrefix()
  * 2. Counts leading ones in the inverted bitstream
  * 3. Encodes the count and remaining bits into an IPv6 address
  * 
+ * The key is handled as four big-endian 64-bit words: the leading ones are
+ * counted a word at a time and the bits after the first zero are cut out
+ * with funnel shifts, so no bit loop and no allocation is involved.
+ * 
  * @param public_key The Ed25519 public key to convert
  * @return IPv6_Addr The generated Yggdrasil IPv6 address 
  */
-inline IPv6_Addr AddrForKey(const PublicKey_t& public_key)
+constexpr IPv6_Addr AddrForKey(const PublicKey_t& public_key)
 {
-    // Invert all bytes in the public key
-    std::array<uint8_t, PublicKey_t::Size> inverted{};
-    for (size_t i = 0; i < PublicKey_t::Size; ++i) {
-        inverted[i] = ~public_key.bytes[i];
-    }
-
-    IPv6_Addr addr{};
-    std::vector<uint8_t> temp;
-    temp.reserve(PublicKey_t::Size);
-
-    bool done = false;  // Flag to indicate we've passed the leading ones
-    uint8_t ones = 0;   // Count of consecutive leading 1-bits
-    uint8_t bits = 0;   // Accumulator for current byte being built
-    int n_bits = 0;     // Number of bits accumulated in current byte
-
-    // Process each bit of the inverted key
-    for (int idx = 0; idx < 8 * static_cast<int>(inverted.size()); ++idx) {
-        // Extract the current bit (idx/8 = byte index, idx%8 = bit position)
-        // 0x80 >> (idx%8) creates a mask for the bit, 7-(idx%8) shifts it to LSB
-        const uint8_t bit =
-            (inverted[idx / 8] & (0x80 >> (idx % 8))) >> (7 - (idx % 8));
-
-        // Count leading ones
-        if (!done and (bit != 0)) {
-            ++ones;
-            continue;
-        }
-
-        // Found first zero, switch to collecting bits
-        if (!done and (bit == 0)) {
-            done = true;
-            assert((ones <= 127) and "ones count exceeds 127");
-            continue;
-        }
+    constexpr size_t KEY_BITS = 8 * PublicKey_t::Size;
+    constexpr size_t WORDS = PublicKey_t::Size / 8;
 
-        // Collect bits after the first zero
-        bits = (bits << 1) | bit;
-        ++n_bits;
+    // Inverted key as big-endian words, then zero words to shift in
+    std::array<uint64_t, WORDS + 2> words{};
+    for (size_t i = 0; i < WORDS; ++i) {
+        words[i] = ~LoadBigEndian64(public_key.bytes.data() + (8 * i));
+    }
 
-        // When we have 8 bits, store the completed byte
-        if (n_bits == 8) {
-            n_bits = 0;
-            temp.push_back(bits);
-            bits = 0;
+    // Count leading ones
+    size_t ones = 0;
+    for (size_t i = 0; i < WORDS; ++i) {
+        const auto word_ones = static_cast<size_t>(std::countl_one(words[i]));
+        ones += word_ones;
+        if (word_ones != 64) {
+            break;
         }
     }
 
-    // Construct the IPv6 address
+    // The address is two big-endian words: the prefix (0x02), the leading
+    // ones count and the 112 bits after the first zero
     const auto prefix = GetPrefix();
+    static_assert(prefix.size() == 1);
+    IPv6_Addr addr{};
+    uint64_t hi = (uint64_t{prefix[0]} << 56U) |
+                  (uint64_t{static_cast<uint8_t>(ones)} << 48U);
+    uint64_t lo = 0;
+
+    if (ones != KEY_BITS) {
+        assert((ones <= 127) and "ones count exceeds 127");
+
+        // The 128 bits after the first zero
+        const size_t first_bit = ones + 1;
+        const size_t word = first_bit / 64;
+        const size_t shift = first_bit % 64;
+        const auto funnel = [&words, shift](size_t i) {
+            return (shift == 0)
+                       ? words[i]
+                       : (words[i] << shift) | (words[i + 1] >> (64 - shift));
+        };
+        uint64_t bits_hi = funnel(word);
+        uint64_t bits_lo = funnel(word + 1);
+
+        // Only whole bytes of the key are used; near its end the rest of
+        // the address stays zero
+        const size_t whole_bits = 8 * ((KEY_BITS - first_bit) / 8);
+        if (whole_bits < 64) {
+            bits_hi &= ~(UINT64_MAX >> whole_bits);
+            bits_lo = 0;
+        }
+        else if (whole_bits < 128) {
+            bits_lo &= ~(UINT64_MAX >> (whole_bits - 64));
+        }
 
-    // Copy the fixed prefix (0x02) to the beginning of the address
-    std::ranges::copy(prefix, addr.bytes.begin());
-
-    // Store the leading ones count in the next byte
-    addr.bytes[prefix.size()] = ones;
-
-    // Calculate how much space remains in the address (16 total bytes)
-    const size_t remaining_space = addr.size() - prefix.size() - 1;  // 14
-
-    // Copy collected bits, but don't overflow the address
-    const size_t copy_size = std::min(temp.size(), remaining_space);
-    std::copy_n(temp.begin(), copy_size,
-                addr.bytes.begin() + prefix.size() + 1);
+        hi |= bits_hi >> 16U;
+        lo = (bits_hi << 48U) | (bits_lo >> 16U);
+    }
 
+    StoreBigEndian64(addr.bytes.data(), hi);
+    StoreBigEndian64(addr.bytes.data() + 8, lo);
     return addr;
 }
 
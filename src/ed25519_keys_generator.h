@@ -28,7 +28,9 @@ extern "C"
 #include <utility>
 #include <vector>
 
+#include "ed25519_batch_engine.h"
 #include "ed25519_keys.h"
+#include "seed_stream.h"
 
 /**
  * @namespace yggdrasil_cpp_genkeys
@@ -44,8 +46,10 @@ static_assert(Seed_t::Size == crypto_sign_ed25519_SEEDBYTES);
 class Ed25519_KeysGenerator
 {
    private:
-    Keys_t keys_{};             ///< keys storage
-    bool initialized_ = false;  ///< Initialization flag
+    Keys_t keys_{};                     ///< keys storage
+    bool initialized_ = false;          ///< Initialization flag
+    Ed25519_BatchEngine batch_engine_;  ///< engine for batched generation
+    SeedStream seeds_;                  ///< seeds of the search
 
    public:
     Ed25519_KeysGenerator() { InitializeSodium(); }
@@ -60,9 +64,10 @@ class Ed25519_KeysGenerator
      * 
      * @param crypto - use random seed for generating
      * 
-     * @remark During the search process, we use a simple increment for 
-     * the key generation seed, which speeds up the process. Since the seed 
-     * was generated randomly at the very beginning, this is quite secure.
+     * @remark During the search process, seeds come from a buffered
+     * ChaCha20 stream keyed from the system RNG (see SeedStream), which is
+     * much cheaper than a system call per key and still makes every key
+     * independent of the others.
      */
     void Generate(bool crypto = false)
     {
@@ -70,7 +75,7 @@ class Ed25519_KeysGenerator
             GenerateRandomSeed();
         }
         else {
-            ++keys_.seed;
+            keys_.seed = seeds_.Next();
         }
         Generate(keys_.seed);
     }
@@ -82,6 +87,92 @@ class Ed25519_KeysGenerator
         assert(result == 0);
     }
 
+    /**
+     * @brief Generates key pairs for the next batch.size() seeds
+     * 
+     * Draws the seeds from the same stream as Generate() and derives all
+     * keys of the batch together, sharing a single field inversion between
+     * them.
+     * 
+     * @param batch storage for generated key sets
+     */
+    void GenerateBatch(std::span<Keys_t> batch)
+    {
+        if (batch.empty()) {
+            return;
+        }
+        seeds_.Fill(batch);
+        GenerateBatchFromSeeds(batch);
+    }
+
+    /**
+     * @brief Generates key pairs for seeds already stored in the batch
+     * 
+     * @param batch key sets with filled seeds
+     */
+    void GenerateBatchFromSeeds(std::span<Keys_t> batch)
+    {
+        if (batch.empty()) {
+            return;
+        }
+        batch_engine_.Generate(batch);
+        keys_ = batch.back();
+    }
+
+    /**
+     * @brief Generates only the y part of the next batch.size() public keys
+     * 
+     * Public keys get bit 255 (the sign of x) clear and secret keys are not
+     * filled. Bytes used for scoring are final, so a caller scores the batch
+     * and calls CompleteBatchKey() for winners only.
+     * 
+     * @param batch storage for generated key sets
+     */
+    void GenerateBatchPartial(std::span<Keys_t> batch)
+    {
+        seeds_.Fill(batch);
+        batch_engine_.GeneratePartial(batch);
+    }
+
+    /**
+     * @brief Completes a key of the last GenerateBatchPartial() batch
+     * 
+     * @param index position of the key in the batch
+     * @param keys the key set stored at that position
+     */
+    void CompleteBatchKey(size_t index, Keys_t& keys)
+    {
+        batch_engine_.Complete(index, keys);
+    }
+
+    /**
+     * @brief Enables variable-time table lookups in batch generation
+     * 
+     * @warning Leaks the secret scalars through timing and cache access
+     * patterns, see Ed25519_BatchEngine::SetUnsafeVartime().
+     */
+    void SetUnsafeVartime(bool enable)
+    {
+        batch_engine_.SetUnsafeVartime(enable);
+    }
+
+    /**
+     * @brief Selects the base table layout used in batch generation
+     * 
+     * @param shape table layout, must be valid
+     */
+    void SetTableShape(const GeTableShape& shape)
+    {
+        batch_engine_.SetTableShape(shape);
+    }
+
+    /**
+     * @brief Interleaves 2 or 4 scalar multiplications in batch generation
+     * 
+     * @param ways keys in lockstep, see Ed25519_BatchEngine::SetInterleave()
+     */
+    void SetInterleave(size_t ways) { batch_engine_.SetInterleave(ways); }
+
     void SetSeed(const Seed_t& seed) { keys_.seed = seed; }
 
     [[nodiscard]]
@@ -0,0 +1,276 @@
+/**
+ * @file fe25519.h
+ * @brief Arithmetic in GF(2^255 - 19) for the batched Ed25519 key engine
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace yggdrasil_cpp_genkeys
+{
+
+__extension__ using uint128_t = unsigned __int128;
+
+/**
+ * @brief Field element of GF(2^255 - 19) in radix 2^51.
+ *
+ * Five unsigned 64-bit limbs, value = sum(v[i] * 2^(51 * i)). Limbs are
+ * allowed to exceed 51 bits between operations (up to about 2^54), the
+ * result of FeMul() and FeSq() is always reduced back to ~51 bits per limb.
+ */
+struct Fe25519
+{
+    std::array<uint64_t, 5> v{};
+};
+
+constexpr uint64_t FE_MASK51 = (uint64_t{1} << 51) - 1;
+
+constexpr Fe25519 FE_ZERO{{0, 0, 0, 0, 0}};
+constexpr Fe25519 FE_ONE{{1, 0, 0, 0, 0}};
+
+/// Edwards curve constant d = -121665 / 121666
+constexpr Fe25519 FE_D{{0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029,
+                        0x739c663a03cbb, 0x52036cee2b6ff}};
+/// 2 * d
+constexpr Fe25519 FE_D2{{0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052,
+                         0x6738cc7407977, 0x2406d9dc56dff}};
+
+static inline Fe25519 FeAdd(const Fe25519& f, const Fe25519& g)
+{
+    return {{f.v[0] + g.v[0], f.v[1] + g.v[1], f.v[2] + g.v[2],
+             f.v[3] + g.v[3], f.v[4] + g.v[4]}};
+}
+
+/**
+ * @brief Computes f - g as f + 4p - g, so limbs never underflow.
+ *
+ * @note g limbs must not exceed 2^53.
+ */
+static inline Fe25519 FeSub(const Fe25519& f, const Fe25519& g)
+{
+    constexpr uint64_t P4_0 = 0x1fffffffffffb4;
+    constexpr uint64_t P4_N = 0x1ffffffffffffc;
+    return {{f.v[0] + P4_0 - g.v[0], f.v[1] + P4_N - g.v[1],
+             f.v[2] + P4_N - g.v[2], f.v[3] + P4_N - g.v[3],
+             f.v[4] + P4_N - g.v[4]}};
+}
+
+static inline Fe25519 FeNeg(const Fe25519& f)
+{
+    return FeSub(FE_ZERO, f);
+}
+
+/**
+ * @brief Propagates carries of 128-bit column sums into 51-bit limbs.
+ */
+static inline Fe25519 FeCarry(uint128_t r0, uint128_t r1, uint128_t r2,
+                              uint128_t r3, uint128_t r4)
+{
+    r1 += r0 >> 51;
+    r2 += r1 >> 51;
+    r3 += r2 >> 51;
+    r4 += r3 >> 51;
+    const uint128_t top = (r4 >> 51) * 19;
+
+    const uint128_t c0 = (static_cast<uint64_t>(r0) & FE_MASK51) + top;
+    uint64_t h1 = (static_cast<uint64_t>(r1) & FE_MASK51) +
+                  static_cast<uint64_t>(c0 >> 51);
+    const uint64_t h0 = static_cast<uint64_t>(c0) & FE_MASK51;
+    const uint64_t h2 = (static_cast<uint64_t>(r2) & FE_MASK51) + (h1 >> 51);
+    h1 &= FE_MASK51;
+    return {{h0, h1, h2, static_cast<uint64_t>(r3) & FE_MASK51,
+             static_cast<uint64_t>(r4) & FE_MASK51}};
+}
+
+static inline Fe25519 FeMul(const Fe25519& f, const Fe25519& g)
+{
+    const uint64_t g1_19 = 19 * g.v[1];
+    const uint64_t g2_19 = 19 * g.v[2];
+    const uint64_t g3_19 = 19 * g.v[3];
+    const uint64_t g4_19 = 19 * g.v[4];
+
+    auto mul = [](uint64_t a, uint64_t b) {
+        return static_cast<uint128_t>(a) * b;
+    };
+
+    const uint128_t r0 = mul(f.v[0], g.v[0]) + mul(f.v[1], g4_19) +
+                         mul(f.v[2], g3_19) + mul(f.v[3], g2_19) +
+                         mul(f.v[4], g1_19);
+    const uint128_t r1 = mul(f.v[0], g.v[1]) + mul(f.v[1], g.v[0]) +
+                         mul(f.v[2], g4_19) + mul(f.v[3], g3_19) +
+                         mul(f.v[4], g2_19);
+    const uint128_t r2 = mul(f.v[0], g.v[2]) + mul(f.v[1], g.v[1]) +
+                         mul(f.v[2], g.v[0]) + mul(f.v[3], g4_19) +
+                         mul(f.v[4], g3_19);
+    const uint128_t r3 = mul(f.v[0], g.v[3]) + mul(f.v[1], g.v[2]) +
+                         mul(f.v[2], g.v[1]) + mul(f.v[3], g.v[0]) +
+                         mul(f.v[4], g4_19);
+    const uint128_t r4 = mul(f.v[0], g.v[4]) + mul(f.v[1], g.v[3]) +
+                         mul(f.v[2], g.v[2]) + mul(f.v[3], g.v[1]) +
+                         mul(f.v[4], g.v[0]);
+
+    return FeCarry(r0, r1, r2, r3, r4);
+}
+
+static inline Fe25519 FeSq(const Fe25519& f)
+{
+    const uint64_t f0_2 = 2 * f.v[0];
+    const uint64_t f1_2 = 2 * f.v[1];
+    const uint64_t f1_38 = 38 * f.v[1];
+    const uint64_t f2_38 = 38 * f.v[2];
+    const uint64_t f3_38 = 38 * f.v[3];
+    const uint64_t f3_19 = 19 * f.v[3];
+    const uint64_t f4_19 = 19 * f.v[4];
+
+    auto mul = [](uint64_t a, uint64_t b) {
+        return static_cast<uint128_t>(a) * b;
+    };
+
+    const uint128_t r0 =
+        mul(f.v[0], f.v[0]) + mul(f1_38, f.v[4]) + mul(f2_38, f.v[3]);
+    const uint128_t r1 =
+        mul(f0_2, f.v[1]) + mul(f2_38, f.v[4]) + mul(f3_19, f.v[3]);
+    const uint128_t r2 =
+        mul(f0_2, f.v[2]) + mul(f.v[1], f.v[1]) + mul(f3_38, f.v[4]);
+    const uint128_t r3 =
+        mul(f0_2, f.v[3]) + mul(f1_2, f.v[2]) + mul(f4_19, f.v[4]);
+    const uint128_t r4 =
+        mul(f0_2, f.v[4]) + mul(f1_2, f.v[3]) + mul(f.v[2], f.v[2]);
+
+    return FeCarry(r0, r1, r2, r3, r4);
+}
+
+/**
+ * @brief Squares f n times in a row.
+ */
+static inline Fe25519 FeSqN(Fe25519 f, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        f = FeSq(f);
+    }
+    return f;
+}
+
+/**
+ * @brief Computes 1 / z as z^(p - 2) with the usual 254 squarings chain.
+ */
+static inline Fe25519 FeInvert(const Fe25519& z)
+{
+    const Fe25519 z2 = FeSq(z);
+    const Fe25519 z9 = FeMul(FeSqN(z2, 2), z);
+    const Fe25519 z11 = FeMul(z9, z2);
+    const Fe25519 z_5_0 = FeMul(FeSq(z11), z9);
+    const Fe25519 z_10_0 = FeMul(FeSqN(z_5_0, 5), z_5_0);
+    const Fe25519 z_20_0 = FeMul(FeSqN(z_10_0, 10), z_10_0);
+    const Fe25519 z_40_0 = FeMul(FeSqN(z_20_0, 20), z_20_0);
+    const Fe25519 z_50_0 = FeMul(FeSqN(z_40_0, 10), z_10_0);
+    const Fe25519 z_100_0 = FeMul(FeSqN(z_50_0, 50), z_50_0);
+    const Fe25519 z_200_0 = FeMul(FeSqN(z_100_0, 100), z_100_0);
+    const Fe25519 z_250_0 = FeMul(FeSqN(z_200_0, 50), z_50_0);
+    return FeMul(FeSqN(z_250_0, 5), z11);
+}
+
+/**
+ * @brief Inverts every element of @p z in place with a single field inversion.
+ *
+ * Montgomery's simultaneous inversion: prefix products are accumulated in
+ * @p scratch, the total product is inverted once and then unwound backwards.
+ * Costs 3 * (n - 1) multiplications plus one FeInvert() instead of n inversions.
+ *
+ * @param z elements to invert, none of them may be zero
+ * @param scratch buffer of at least z.size() elements
+ */
+static inline void FeBatchInvert(std::span<Fe25519> z,
+                                 std::span<Fe25519> scratch)
+{
+    if (z.empty()) {
+        return;
+    }
+
+    scratch[0] = z[0];
+    for (size_t i = 1; i < z.size(); ++i) {
+        scratch[i] = FeMul(scratch[i - 1], z[i]);
+    }
+
+    Fe25519 inv = FeInvert(scratch[z.size() - 1]);
+    for (size_t i = z.size() - 1; i > 0; --i) {
+        const Fe25519 z_inv = FeMul(inv, scratch[i - 1]);
+        inv = FeMul(inv, z[i]);
+        z[i] = z_inv;
+    }
+    z[0] = inv;
+}
+
+static inline Fe25519 FeFromBytes(std::span<const uint8_t, 32> bytes)
+{
+    auto load64 = [&bytes](size_t offset) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            word |= static_cast<uint64_t>(bytes[offset + i]) << (8 * i);
+        }
+        return word;
+    };
+
+    return {{load64(0) & FE_MASK51, (load64(6) >> 3) & FE_MASK51,
+             (load64(12) >> 6) & FE_MASK51, (load64(19) >> 1) & FE_MASK51,
+             (load64(24) >> 12) & FE_MASK51}};
+}
+
+/**
+ * @brief Serializes f in canonical (fully reduced) little-endian form.
+ */
+static inline std::array<uint8_t, 32> FeToBytes(const Fe25519& f)
+{
+    // bring limbs below 2^51, the value is then below 2^255 + small
+    Fe25519 t = FeCarry(f.v[0], f.v[1], f.v[2], f.v[3], f.v[4]);
+
+    // q = 1 iff t >= p
+    uint64_t q = (t.v[0] + 19) >> 51;
+    q = (t.v[1] + q) >> 51;
+    q = (t.v[2] + q) >> 51;
+    q = (t.v[3] + q) >> 51;
+    q = (t.v[4] + q) >> 51;
+
+    t.v[0] += 19 * q;
+    t.v[1] += t.v[0] >> 51;
+    t.v[0] &= FE_MASK51;
+    t.v[2] += t.v[1] >> 51;
+    t.v[1] &= FE_MASK51;
+    t.v[3] += t.v[2] >> 51;
+    t.v[2] &= FE_MASK51;
+    t.v[4] += t.v[3] >> 51;
+    t.v[3] &= FE_MASK51;
+    t.v[4] &= FE_MASK51;
+
+    const std::array<uint64_t, 4> words = {
+        t.v[0] | (t.v[1] << 51), (t.v[1] >> 13) | (t.v[2] << 38),
+        (t.v[2] >> 26) | (t.v[3] << 25), (t.v[3] >> 39) | (t.v[4] << 12)};
+
+    std::array<uint8_t, 32> bytes{};
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(words[i / 8] >> (8 * (i % 8)));
+    }
+    return bytes;
+}
+
+static inline bool FeIsNegative(const Fe25519& f)
+{
+    return (FeToBytes(f)[0] & 1) != 0;
+}
+
+/**
+ * @brief Constant-time conditional move: f = g if flag is 1, unchanged if 0.
+ */
+static inline void FeCMov(Fe25519& f, const Fe25519& g, uint64_t flag)
+{
+    const uint64_t mask = 0 - flag;
+    for (size_t i = 0; i < f.v.size(); ++i) {
+        f.v[i] ^= mask & (f.v[i] ^ g.v[i]);
+    }
+}
+
+}  // namespace yggdrasil_cpp_genkeys
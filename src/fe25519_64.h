@@ -0,0 +1,403 @@
+/**
+ * @file fe25519_64.h
+ * @brief BMI2/ADX arithmetic in GF(2^255 - 19) with 64-bit limbs
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#if defined(__x86_64__)
+
+#include <immintrin.h>
+
+#include <array>
+#include <cstdint>
+
+#include "fe25519.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+constexpr size_t FE_64_LIMBS = 4;
+
+/**
+ * @brief Field element of GF(2^255 - 19) in radix 2^64.
+ *
+ * Four full 64-bit limbs, value = sum(v[i] * 2^(64 * i)) < 2^256. Elements
+ * are only reduced modulo 2^256 - 38 (= 2 * p), Fe64ToFe() hands them back
+ * to the radix 2^51 code for the canonical encoding.
+ *
+ * A product takes 16 mulx instead of the 25 multiplications of radix 2^51,
+ * its partial products are summed along two independent carry chains
+ * (adcx and adox) and 2^256 = 38 folds the upper half back in four more.
+ * Limbs are unsigned long long, the type the intrinsics take.
+ */
+struct Fe64
+{
+    std::array<unsigned long long, FE_64_LIMBS> v{};
+};
+
+namespace fe_64
+{
+
+using Limb = unsigned long long;
+
+/**
+ * @brief Adds 38 * carry to a 256-bit value that overflowed by @p carry.
+ *
+ * The second fold cannot carry again: after a wrap-around the value is
+ * far below 2^256 - 38 * 2^6.
+ */
+[[gnu::target("bmi2,adx")]] static inline Fe64 Fold(Limb h0, Limb h1,
+                                                    Limb h2, Limb h3,
+                                                    Limb carry)
+{
+    unsigned char c = _addcarryx_u64(0, h0, carry * 38, &h0);
+    c = _addcarryx_u64(c, h1, 0, &h1);
+    c = _addcarryx_u64(c, h2, 0, &h2);
+    c = _addcarryx_u64(c, h3, 0, &h3);
+    h0 += Limb{38} & (0 - static_cast<Limb>(c));
+    return {{h0, h1, h2, h3}};
+}
+
+/// 512-bit product, t[i] is the limb of 2^(64 * i)
+using Wide = std::array<Limb, 2 * FE_64_LIMBS>;
+
+/**
+ * @brief 4x4 limb schoolbook product.
+ *
+ * Rows 1..3 add their low halves into the accumulator on the adox (OF)
+ * chain and their high halves on the adcx (CF) chain, so the two carry
+ * chains of a row run side by side. The compiler does not emit adcx/adox
+ * from intrinsics, hence the inline assembly.
+ */
+[[gnu::target("bmi2,adx")]] static inline Wide MulWide(const Fe64& f,
+                                                       const Fe64& g)
+{
+    const Limb f0 = f.v[0];
+    const Limb f1 = f.v[1];
+    const Limb f2 = f.v[2];
+    const Limb f3 = f.v[3];
+    const Limb g0 = g.v[0];
+    const Limb g1 = g.v[1];
+    const Limb g2 = g.v[2];
+    const Limb g3 = g.v[3];
+    Limb t0 = 0;
+    Limb t1 = 0;
+    Limb t2 = 0;
+    Limb t3 = 0;
+    Limb t4 = 0;
+    Limb t5 = 0;
+    Limb t6 = 0;
+    Limb t7 = 0;
+    Limb lo = 0;
+    Limb hi = 0;
+    const Limb zero = 0;  // source operand for adding a bare carry
+    asm("movq %[f0], %%rdx\n\t"
+        "mulxq %[g0], %[t0], %[t1]\n\t"
+        "mulxq %[g1], %[lo], %[t2]\n\t"
+        "addq %[lo], %[t1]\n\t"
+        "mulxq %[g2], %[lo], %[t3]\n\t"
+        "adcq %[lo], %[t2]\n\t"
+        "mulxq %[g3], %[lo], %[t4]\n\t"
+        "adcq %[lo], %[t3]\n\t"
+        "adcq $0, %[t4]"
+        : [t0] "=&r"(t0), [t1] "=&r"(t1), [t2] "=&r"(t2), [t3] "=&r"(t3),
+          [t4] "=&r"(t4), [lo] "=&r"(lo)
+        : [f0] "m"(f0), [g0] "m"(g0), [g1] "m"(g1), [g2] "m"(g2),
+          [g3] "m"(g3)
+        : "rdx", "cc");
+    // t0 is final, leaving it out keeps the register demand low enough for
+    // unoptimized builds
+    asm("movq %[f1], %%rdx\n\t"
+        "xorl %k[lo], %k[lo]\n\t"  // clears CF and OF
+        "mulxq %[g0], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t1]\n\t"
+        "adcxq %[hi], %[t2]\n\t"
+        "mulxq %[g1], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t2]\n\t"
+        "adcxq %[hi], %[t3]\n\t"
+        "mulxq %[g2], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t3]\n\t"
+        "adcxq %[hi], %[t4]\n\t"
+        "mulxq %[g3], %[lo], %[t5]\n\t"
+        "adoxq %[lo], %[t4]\n\t"
+        "adcxq %[zero], %[t5]\n\t"
+        "adoxq %[zero], %[t5]\n\t"
+
+        "movq %[f2], %%rdx\n\t"
+        "xorl %k[lo], %k[lo]\n\t"
+        "mulxq %[g0], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t2]\n\t"
+        "adcxq %[hi], %[t3]\n\t"
+        "mulxq %[g1], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t3]\n\t"
+        "adcxq %[hi], %[t4]\n\t"
+        "mulxq %[g2], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t4]\n\t"
+        "adcxq %[hi], %[t5]\n\t"
+        "mulxq %[g3], %[lo], %[t6]\n\t"
+        "adoxq %[lo], %[t5]\n\t"
+        "adcxq %[zero], %[t6]\n\t"
+        "adoxq %[zero], %[t6]\n\t"
+
+        "movq %[f3], %%rdx\n\t"
+        "xorl %k[lo], %k[lo]\n\t"
+        "mulxq %[g0], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t3]\n\t"
+        "adcxq %[hi], %[t4]\n\t"
+        "mulxq %[g1], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t4]\n\t"
+        "adcxq %[hi], %[t5]\n\t"
+        "mulxq %[g2], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t5]\n\t"
+        "adcxq %[hi], %[t6]\n\t"
+        "mulxq %[g3], %[lo], %[t7]\n\t"
+        "adoxq %[lo], %[t6]\n\t"
+        "adcxq %[zero], %[t7]\n\t"
+        "adoxq %[zero], %[t7]"
+        : [t1] "+&r"(t1), [t2] "+&r"(t2), [t3] "+&r"(t3), [t4] "+&r"(t4),
+          [t5] "=&r"(t5), [t6] "=&r"(t6), [t7] "=&r"(t7), [lo] "=&r"(lo),
+          [hi] "=&r"(hi)
+        : [f1] "m"(f1), [f2] "m"(f2), [f3] "m"(f3), [g0] "m"(g0),
+          [g1] "m"(g1), [g2] "m"(g2), [g3] "m"(g3), [zero] "m"(zero)
+        : "rdx", "cc");
+    return {t0, t1, t2, t3, t4, t5, t6, t7};
+}
+
+/**
+ * @brief Square with the 6 cross products computed once and doubled.
+ */
+[[gnu::target("bmi2,adx")]] static inline Wide SqWide(const Fe64& f)
+{
+    const Limb f0 = f.v[0];
+    const Limb f1 = f.v[1];
+    const Limb f2 = f.v[2];
+    const Limb f3 = f.v[3];
+    Limb t0 = 0;
+    Limb t1 = 0;
+    Limb t2 = 0;
+    Limb t3 = 0;
+    Limb t4 = 0;
+    Limb t5 = 0;
+    Limb t6 = 0;
+    Limb t7 = 0;
+    Limb lo = 0;
+    Limb hi = 0;
+    const Limb zero = 0;  // source operand for adding a bare carry
+    asm(  // f0 * (f1, f2, f3) at limbs 1..4
+        "movq %[f0], %%rdx\n\t"
+        "mulxq %[f1], %[t1], %[t2]\n\t"
+        "mulxq %[f2], %[lo], %[t3]\n\t"
+        "addq %[lo], %[t2]\n\t"
+        "mulxq %[f3], %[lo], %[t4]\n\t"
+        "adcq %[lo], %[t3]\n\t"
+        "adcq $0, %[t4]\n\t"
+        // f1 * (f2, f3) at limbs 3..5
+        "movq %[f1], %%rdx\n\t"
+        "xorl %k[lo], %k[lo]\n\t"  // clears CF and OF
+        "mulxq %[f2], %[lo], %[hi]\n\t"
+        "adoxq %[lo], %[t3]\n\t"
+        "adcxq %[hi], %[t4]\n\t"
+        "mulxq %[f3], %[lo], %[t5]\n\t"
+        "adoxq %[lo], %[t4]\n\t"
+        "adcxq %[zero], %[t5]\n\t"
+        "adoxq %[zero], %[t5]\n\t"
+        // f2 * f3 at limbs 5..6
+        "movq %[f2], %%rdx\n\t"
+        "mulxq %[f3], %[lo], %[t6]\n\t"
+        "addq %[lo], %[t5]\n\t"
+        "adcq $0, %[t6]\n\t"
+        // double the cross products
+        "xorl %k[t7], %k[t7]\n\t"
+        "addq %[t1], %[t1]\n\t"
+        "adcq %[t2], %[t2]\n\t"
+        "adcq %[t3], %[t3]\n\t"
+        "adcq %[t4], %[t4]\n\t"
+        "adcq %[t5], %[t5]\n\t"
+        "adcq %[t6], %[t6]\n\t"
+        "adcq $0, %[t7]\n\t"
+        // add the squares f_i^2 at limbs 2i..2i+1, mulx keeps CF intact
+        "movq %[f0], %%rdx\n\t"
+        "mulxq %%rdx, %[t0], %[hi]\n\t"
+        "addq %[hi], %[t1]\n\t"
+        "movq %[f1], %%rdx\n\t"
+        "mulxq %%rdx, %[lo], %[hi]\n\t"
+        "adcq %[lo], %[t2]\n\t"
+        "adcq %[hi], %[t3]\n\t"
+        "movq %[f2], %%rdx\n\t"
+        "mulxq %%rdx, %[lo], %[hi]\n\t"
+        "adcq %[lo], %[t4]\n\t"
+        "adcq %[hi], %[t5]\n\t"
+        "movq %[f3], %%rdx\n\t"
+        "mulxq %%rdx, %[lo], %[hi]\n\t"
+        "adcq %[lo], %[t6]\n\t"
+        "adcq %[hi], %[t7]"
+        : [t0] "=&r"(t0), [t1] "=&r"(t1), [t2] "=&r"(t2), [t3] "=&r"(t3),
+          [t4] "=&r"(t4), [t5] "=&r"(t5), [t6] "=&r"(t6), [t7] "=&r"(t7),
+          [lo] "=&r"(lo), [hi] "=&r"(hi)
+        : [f0] "m"(f0), [f1] "m"(f1), [f2] "m"(f2),
+          [f3] "m"(f3), [zero] "m"(zero)
+        : "rdx", "cc");
+    return {t0, t1, t2, t3, t4, t5, t6, t7};
+}
+
+/**
+ * @brief Reduces a 512-bit product lo + 2^256 * hi to lo + 38 * hi.
+ *
+ * The low halves of 38 * hi go on the CF chain and the high halves on the
+ * OF chain. The remaining top limb (< 2^6) is folded in once more.
+ */
+[[gnu::target("bmi2,adx")]] static inline Fe64 Reduce(Wide t)
+{
+    Limb lo = 0;
+    Limb hi = 0;
+    const Limb zero = 0;
+    asm("movl $38, %%edx\n\t"
+        "xorl %k[lo], %k[lo]\n\t"  // clears CF and OF
+        "mulxq %[t4], %[lo], %[hi]\n\t"
+        "adcxq %[lo], %[t0]\n\t"
+        "adoxq %[hi], %[t1]\n\t"
+        "mulxq %[t5], %[lo], %[hi]\n\t"
+        "adcxq %[lo], %[t1]\n\t"
+        "adoxq %[hi], %[t2]\n\t"
+        "mulxq %[t6], %[lo], %[hi]\n\t"
+        "adcxq %[lo], %[t2]\n\t"
+        "adoxq %[hi], %[t3]\n\t"
+        "mulxq %[t7], %[lo], %[t4]\n\t"
+        "adcxq %[lo], %[t3]\n\t"
+        "adcxq %[zero], %[t4]\n\t"
+        "adoxq %[zero], %[t4]\n\t"
+        // top * 38 < 2^12; a carry out of that leaves t0 tiny
+        "imulq $38, %[t4], %[t4]\n\t"
+        "addq %[t4], %[t0]\n\t"
+        "adcq $0, %[t1]\n\t"
+        "adcq $0, %[t2]\n\t"
+        "adcq $0, %[t3]\n\t"
+        "sbbq %[t4], %[t4]\n\t"
+        "andq $38, %[t4]\n\t"
+        "addq %[t4], %[t0]"
+        : [t0] "+&r"(t[0]), [t1] "+&r"(t[1]), [t2] "+&r"(t[2]),
+          [t3] "+&r"(t[3]), [t4] "+&r"(t[4]), [lo] "=&r"(lo), [hi] "=&r"(hi)
+        : [t5] "r"(t[5]), [t6] "r"(t[6]), [t7] "r"(t[7]), [zero] "m"(zero)
+        : "rdx", "cc");
+    return {{t[0], t[1], t[2], t[3]}};
+}
+
+}  // namespace fe_64
+
+[[gnu::target("bmi2,adx")]] static inline Fe64 Fe64Add(const Fe64& f,
+                                                       const Fe64& g)
+{
+    fe_64::Limb h0 = 0;
+    fe_64::Limb h1 = 0;
+    fe_64::Limb h2 = 0;
+    fe_64::Limb h3 = 0;
+    unsigned char c = _addcarryx_u64(0, f.v[0], g.v[0], &h0);
+    c = _addcarryx_u64(c, f.v[1], g.v[1], &h1);
+    c = _addcarryx_u64(c, f.v[2], g.v[2], &h2);
+    c = _addcarryx_u64(c, f.v[3], g.v[3], &h3);
+    return fe_64::Fold(h0, h1, h2, h3, c);
+}
+
+/**
+ * @brief Computes f - g, a borrow of 2^256 is replaced by one of 38.
+ */
+[[gnu::target("bmi2,adx")]] static inline Fe64 Fe64Sub(const Fe64& f,
+                                                       const Fe64& g)
+{
+    using fe_64::Limb;
+    Limb h0 = 0;
+    Limb h1 = 0;
+    Limb h2 = 0;
+    Limb h3 = 0;
+    unsigned char b = _subborrow_u64(0, f.v[0], g.v[0], &h0);
+    b = _subborrow_u64(b, f.v[1], g.v[1], &h1);
+    b = _subborrow_u64(b, f.v[2], g.v[2], &h2);
+    b = _subborrow_u64(b, f.v[3], g.v[3], &h3);
+
+    b = _subborrow_u64(0, h0, Limb{38} & (0 - Limb{b}), &h0);
+    b = _subborrow_u64(b, h1, 0, &h1);
+    b = _subborrow_u64(b, h2, 0, &h2);
+    b = _subborrow_u64(b, h3, 0, &h3);
+    // a second borrow leaves h0 close to 2^64, far from underflowing
+    h0 -= Limb{38} & (0 - Limb{b});
+    return {{h0, h1, h2, h3}};
+}
+
+[[gnu::target("bmi2,adx")]] static inline Fe64 Fe64Neg(const Fe64& f)
+{
+    return Fe64Sub(Fe64{}, f);
+}
+
+[[gnu::target("bmi2,adx")]] static inline Fe64 Fe64Mul(const Fe64& f,
+                                                       const Fe64& g)
+{
+    return fe_64::Reduce(fe_64::MulWide(f, g));
+}
+
+/**
+ * @brief Squares f with 10 mulx instead of 16.
+ */
+[[gnu::target("bmi2,adx")]] static inline Fe64 Fe64Sq(const Fe64& f)
+{
+    return fe_64::Reduce(fe_64::SqWide(f));
+}
+
+/**
+ * @brief Repacks a radix 2^51 element, limbs may be up to 64 bits wide.
+ */
+static inline Fe64 Fe64FromFe(const Fe25519& f)
+{
+    Fe64 h;
+    uint128_t acc = f.v[0] + (static_cast<uint128_t>(f.v[1]) << 51);
+    h.v[0] = static_cast<uint64_t>(acc);
+    acc = (acc >> 64) + (static_cast<uint128_t>(f.v[2]) << 38);
+    h.v[1] = static_cast<uint64_t>(acc);
+    acc = (acc >> 64) + (static_cast<uint128_t>(f.v[3]) << 25);
+    h.v[2] = static_cast<uint64_t>(acc);
+    acc = (acc >> 64) + (static_cast<uint128_t>(f.v[4]) << 12);
+    h.v[3] = static_cast<uint64_t>(acc);
+
+    // fold whatever reached 2^256 with 2^256 = 38 (mod p)
+    acc = static_cast<uint128_t>(h.v[0]) + ((acc >> 64) * 38);
+    h.v[0] = static_cast<uint64_t>(acc);
+    for (size_t i = 1; i < FE_64_LIMBS; ++i) {
+        acc = (acc >> 64) + h.v[i];
+        h.v[i] = static_cast<uint64_t>(acc);
+    }
+    h.v[0] += 38 * static_cast<uint64_t>(acc >> 64);
+    return h;
+}
+
+/**
+ * @brief Splits into radix 2^51 limbs of at most 51 bits (+ a tiny carry).
+ */
+static inline Fe25519 Fe64ToFe(const Fe64& f)
+{
+    Fe25519 h{{f.v[0] & FE_MASK51,
+               ((f.v[0] >> 51) | (f.v[1] << 13)) & FE_MASK51,
+               ((f.v[1] >> 38) | (f.v[2] << 26)) & FE_MASK51,
+               ((f.v[2] >> 25) | (f.v[3] << 39)) & FE_MASK51, f.v[3] >> 12}};
+    // the top limb has 52 bits, 2^255 = 19 (mod p)
+    h.v[0] += 19 * (h.v[4] >> 51);
+    h.v[4] &= FE_MASK51;
+    return h;
+}
+
+/**
+ * @brief Selects g if flag is 1, f if 0, in constant time.
+ */
+static inline Fe64 Fe64Select(const Fe64& f, const Fe64& g, uint64_t flag)
+{
+    const uint64_t mask = 0 - flag;
+    Fe64 h;
+    for (size_t i = 0; i < FE_64_LIMBS; ++i) {
+        h.v[i] = f.v[i] ^ (mask & (f.v[i] ^ g.v[i]));
+    }
+    return h;
+}
+
+}  // namespace yggdrasil_cpp_genkeys
+
+#endif
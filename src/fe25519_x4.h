@@ -0,0 +1,212 @@
+/**
+ * @file fe25519_x4.h
+ * @brief Four-lane AVX2 arithmetic in GF(2^255 - 19)
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include <array>
+#include <cstdint>
+
+#include "fe25519.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+constexpr size_t FE_X4_LIMBS = 10;
+
+/**
+ * @brief Four independent field elements, one per 64-bit AVX2 lane.
+ *
+ * Radix 2^25.5 (ref10 layout): limb i holds 26 bits for even i and 25 bits
+ * for odd i, and v[i] carries limb i of all four lanes. The 32x32->64 bit
+ * _mm256_mul_epu32 multiplies one limb pair of every lane at once.
+ *
+ * Limbs are unsigned. "Reduced" limbs (the FeX4Mul() output) stay below
+ * 2^26 / 2^25 (+ a tiny carry in limbs 1 and 5). FeX4Mul() inputs may be a
+ * sum or difference of two reduced elements, anything wider must go through
+ * FeX4Carry() first.
+ */
+struct FeX4
+{
+    __m256i v[FE_X4_LIMBS];  // NOLINT(*-avoid-c-arrays)
+};
+
+namespace fe_x4
+{
+
+[[gnu::target("avx2")]] static inline __m256i Mask(int bits)
+{
+    return _mm256_set1_epi64x((int64_t{1} << bits) - 1);
+}
+
+/// 19 * x for 64-bit lanes wider than 32 bits
+[[gnu::target("avx2")]] static inline __m256i Times19(__m256i x)
+{
+    return _mm256_add_epi64(
+        _mm256_add_epi64(_mm256_slli_epi64(x, 4), _mm256_slli_epi64(x, 1)), x);
+}
+
+[[gnu::target("avx2")]] static inline void CarryStep(FeX4& h, size_t i)
+{
+    const int bits = (i % 2 == 0) ? 26 : 25;
+    const __m256i carry = _mm256_srli_epi64(h.v[i], bits);
+    h.v[i] = _mm256_and_si256(h.v[i], Mask(bits));
+    if (i == 9) {
+        h.v[0] = _mm256_add_epi64(h.v[0], Times19(carry));
+    }
+    else {
+        h.v[i + 1] = _mm256_add_epi64(h.v[i + 1], carry);
+    }
+}
+
+}  // namespace fe_x4
+
+/**
+ * @brief Brings every limb back to reduced width (two interleaved chains).
+ */
+[[gnu::target("avx2")]] static inline void FeX4Carry(FeX4& h)
+{
+    using fe_x4::CarryStep;
+    CarryStep(h, 0);
+    CarryStep(h, 4);
+    CarryStep(h, 1);
+    CarryStep(h, 5);
+    CarryStep(h, 2);
+    CarryStep(h, 6);
+    CarryStep(h, 3);
+    CarryStep(h, 7);
+    CarryStep(h, 4);
+    CarryStep(h, 8);
+    CarryStep(h, 9);
+    CarryStep(h, 0);
+}
+
+[[gnu::target("avx2")]] static inline FeX4 FeX4Add(const FeX4& f,
+                                                   const FeX4& g)
+{
+    FeX4 h;
+    for (size_t i = 0; i < FE_X4_LIMBS; ++i) {
+        h.v[i] = _mm256_add_epi64(f.v[i], g.v[i]);
+    }
+    return h;
+}
+
+/**
+ * @brief Computes f - g as f + 2p - g, g must be reduced.
+ */
+[[gnu::target("avx2")]] static inline FeX4 FeX4Sub(const FeX4& f,
+                                                   const FeX4& g)
+{
+    const __m256i p2_0 = _mm256_set1_epi64x(0x7ffffda);
+    const __m256i p2_even = _mm256_set1_epi64x(0x7fffffe);
+    const __m256i p2_odd = _mm256_set1_epi64x(0x3fffffe);
+
+    FeX4 h;
+    for (size_t i = 0; i < FE_X4_LIMBS; ++i) {
+        const __m256i p2 = (i == 0) ? p2_0 : ((i % 2 == 0) ? p2_even : p2_odd);
+        h.v[i] = _mm256_sub_epi64(_mm256_add_epi64(f.v[i], p2), g.v[i]);
+    }
+    return h;
+}
+
+[[gnu::target("avx2")]] static inline FeX4 FeX4Mul(const FeX4& f,
+                                                   const FeX4& g)
+{
+    // odd limbs of f doubled (odd * odd products carry an extra factor 2),
+    // limbs of g premultiplied by 19 for the wrap-around 2^255 = 19
+    __m256i f2[FE_X4_LIMBS];   // NOLINT(*-avoid-c-arrays)
+    __m256i g19[FE_X4_LIMBS];  // NOLINT(*-avoid-c-arrays)
+    for (size_t i = 0; i < FE_X4_LIMBS; ++i) {
+        f2[i] = (i % 2 == 1) ? _mm256_add_epi64(f.v[i], f.v[i]) : f.v[i];
+        g19[i] = _mm256_mul_epu32(g.v[i], _mm256_set1_epi64x(19));
+    }
+
+    // fully unrolled so that all limb indices and factors are constants
+    FeX4 h;
+#pragma GCC unroll 10
+    for (size_t k = 0; k < FE_X4_LIMBS; ++k) {
+        __m256i sum = _mm256_setzero_si256();
+#pragma GCC unroll 10
+        for (size_t i = 0; i < FE_X4_LIMBS; ++i) {
+            const bool both_odd = (i % 2 == 1) and ((k - i) % 2 == 1);
+            const __m256i fi = both_odd ? f2[i] : f.v[i];
+            const __m256i product =
+                (i <= k) ? _mm256_mul_epu32(fi, g.v[k - i])
+                         : _mm256_mul_epu32(fi, g19[k + 10 - i]);
+            sum = _mm256_add_epi64(sum, product);
+        }
+        h.v[k] = sum;
+    }
+
+    FeX4Carry(h);
+    return h;
+}
+
+/**
+ * @brief Lane-wise select: r = mask ? g : f, mask lanes are all-ones or zero.
+ */
+[[gnu::target("avx2")]] static inline FeX4 FeX4Select(const FeX4& f,
+                                                      const FeX4& g,
+                                                      __m256i mask)
+{
+    FeX4 h;
+    for (size_t i = 0; i < FE_X4_LIMBS; ++i) {
+        h.v[i] = _mm256_blendv_epi8(f.v[i], g.v[i], mask);
+    }
+    return h;
+}
+
+/**
+ * @brief Splits radix 2^51 limbs of four lanes into radix 2^25.5 limbs.
+ *
+ * @param limbs limbs[j] holds limb j of every lane, each below 2^51
+ */
+[[gnu::target("avx2")]] static inline FeX4 FeX4FromLimbs51(
+    const __m256i (&limbs)[5])  // NOLINT(*-avoid-c-arrays)
+{
+    FeX4 h;
+    for (size_t j = 0; j < 5; ++j) {
+        h.v[2 * j] = _mm256_and_si256(limbs[j], fe_x4::Mask(26));
+        h.v[(2 * j) + 1] = _mm256_srli_epi64(limbs[j], 26);
+    }
+    return h;
+}
+
+[[gnu::target("avx2")]] static inline FeX4 FeX4Broadcast(const Fe25519& f)
+{
+    __m256i limbs[5];  // NOLINT(*-avoid-c-arrays)
+    for (size_t j = 0; j < 5; ++j) {
+        limbs[j] = _mm256_set1_epi64x(static_cast<int64_t>(f.v[j]));
+    }
+    return FeX4FromLimbs51(limbs);
+}
+
+/**
+ * @brief Extracts one lane as a radix 2^51 element (limbs may be loose).
+ */
+[[gnu::target("avx2")]] static inline Fe25519 FeX4Extract(const FeX4& f,
+                                                          size_t lane)
+{
+    std::array<uint64_t, FE_X4_LIMBS> limbs{};
+    for (size_t i = 0; i < limbs.size(); ++i) {
+        alignas(32) std::array<uint64_t, 4> lanes{};
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.data()), f.v[i]);
+        limbs[i] = lanes[lane];
+    }
+
+    Fe25519 h;
+    for (size_t j = 0; j < h.v.size(); ++j) {
+        h.v[j] = limbs[2 * j] + (limbs[(2 * j) + 1] << 26);
+    }
+    return h;
+}
+
+}  // namespace yggdrasil_cpp_genkeys
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file ge25519.h
+ * @brief Ed25519 group operations and point encoding
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "fe25519.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Point in extended twisted Edwards coordinates (X:Y:Z:T), x = X/Z,
+ * y = Y/Z, x * y = T/Z.
+ */
+struct GeP3
+{
+    Fe25519 x;
+    Fe25519 y;
+    Fe25519 z;
+    Fe25519 t;
+};
+
+/**
+ * @brief Affine point prepared for mixed addition: (y + x, y - x, 2 * d * x * y).
+ */
+struct GePrecomp
+{
+    Fe25519 y_plus_x;
+    Fe25519 y_minus_x;
+    Fe25519 xy2d;
+};
+
+/// Neutral element (0, 1)
+constexpr GeP3 GE_IDENTITY{FE_ZERO, FE_ONE, FE_ONE, FE_ZERO};
+
+/// Ed25519 base point B, y = 4/5
+constexpr GeP3 GE_BASE{
+    {{0x62d608f25d51a, 0x412a4b4f6592a, 0x75b7171a4b31d, 0x1ff60527118fe,
+      0x216936d3cd6e5}},
+    {{0x6666666666658, 0x4cccccccccccc, 0x1999999999999, 0x3333333333333,
+      0x6666666666666}},
+    FE_ONE,
+    {{0x68ab3a5b7dda3, 0xeea2a5eadbb, 0x2af8df483c27e, 0x332b375274732,
+      0x67875f0fd78b7}}};
+
+/**
+ * @brief Complete addition P + Q of two extended points (a = -1 formulas).
+ */
+static inline GeP3 GeAdd(const GeP3& p, const GeP3& q)
+{
+    const Fe25519 a = FeMul(FeSub(p.y, p.x), FeSub(q.y, q.x));
+    const Fe25519 b = FeMul(FeAdd(p.y, p.x), FeAdd(q.y, q.x));
+    const Fe25519 c = FeMul(FeMul(p.t, q.t), FE_D2);
+    const Fe25519 zz = FeMul(p.z, q.z);
+    const Fe25519 d = FeAdd(zz, zz);
+    const Fe25519 e = FeSub(b, a);
+    const Fe25519 f = FeSub(d, c);
+    const Fe25519 g = FeAdd(d, c);
+    const Fe25519 h = FeAdd(b, a);
+    return {FeMul(e, f), FeMul(g, h), FeMul(f, g), FeMul(e, h)};
+}
+
+/**
+ * @brief Mixed addition P + Q where Q is an affine precomputed point.
+ */
+static inline GeP3 GeMAdd(const GeP3& p, const GePrecomp& q)
+{
+    const Fe25519 a = FeMul(FeSub(p.y, p.x), q.y_minus_x);
+    const Fe25519 b = FeMul(FeAdd(p.y, p.x), q.y_plus_x);
+    const Fe25519 c = FeMul(p.t, q.xy2d);
+    const Fe25519 d = FeAdd(p.z, p.z);
+    const Fe25519 e = FeSub(b, a);
+    const Fe25519 f = FeSub(d, c);
+    const Fe25519 g = FeAdd(d, c);
+    const Fe25519 h = FeAdd(b, a);
+    return {FeMul(e, f), FeMul(g, h), FeMul(f, g), FeMul(e, h)};
+}
+
+/**
+ * @brief Point doubling 2 * P (dbl-2008-hwcd, a = -1).
+ */
+static inline GeP3 GeDouble(const GeP3& p)
+{
+    const Fe25519 a = FeSq(p.x);
+    const Fe25519 b = FeSq(p.y);
+    const Fe25519 zz = FeSq(p.z);
+    const Fe25519 c = FeAdd(zz, zz);
+    const Fe25519 h = FeAdd(a, b);
+    const Fe25519 e = FeSub(h, FeSq(FeAdd(p.x, p.y)));
+    const Fe25519 g = FeSub(a, b);
+    const Fe25519 f = FeAdd(c, g);
+    return {FeMul(e, f), FeMul(g, h), FeMul(f, g), FeMul(e, h)};
+}
+
+/**
+ * @brief Writes the first part of the encoding: little-endian y, bit 255 clear.
+ *
+ * Bytes 0..30 and the low 7 bits of byte 31 are final after this call.
+ */
+static inline void GeEncodeY(const GeP3& p, const Fe25519& z_inv,
+                             std::span<uint8_t, 32> out)
+{
+    const auto bytes = FeToBytes(FeMul(p.y, z_inv));
+    std::ranges::copy(bytes, out.begin());
+}
+
+/**
+ * @brief Completes GeEncodeY() output with the sign of x in bit 255.
+ */
+static inline void GeEncodeSign(const GeP3& p, const Fe25519& z_inv,
+                                std::span<uint8_t, 32> out)
+{
+    const Fe25519 x = FeMul(p.x, z_inv);
+    out[31] |= static_cast<uint8_t>(FeIsNegative(x) ? 0x80 : 0);
+}
+
+/**
+ * @brief Encodes a point given the inverse of its Z coordinate.
+ *
+ * Standard Ed25519 encoding: little-endian y with the sign of x in bit 255.
+ */
+static inline void GeEncode(const GeP3& p, const Fe25519& z_inv,
+                            std::span<uint8_t, 32> out)
+{
+    GeEncodeY(p, z_inv, out);
+    GeEncodeSign(p, z_inv, out);
+}
+
+}  // namespace yggdrasil_cpp_genkeys
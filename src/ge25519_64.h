@@ -0,0 +1,155 @@
+/**
+ * @file ge25519_64.h
+ * @brief BMI2/ADX Ed25519 fixed-base scalar multiplication with 64-bit limbs
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#if defined(__x86_64__)
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "fe25519_64.h"
+#include "ge25519.h"
+#include "ge25519_base_table.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Extended point with radix 2^64 coordinates.
+ */
+struct Ge64P3
+{
+    Fe64 x;
+    Fe64 y;
+    Fe64 z;
+    Fe64 t;
+};
+
+/**
+ * @brief Affine precomputed point with radix 2^64 coordinates.
+ */
+struct Ge64Precomp
+{
+    Fe64 y_plus_x;
+    Fe64 y_minus_x;
+    Fe64 xy2d;
+};
+
+/**
+ * @brief Mixed addition, same formulas as GeMAdd().
+ */
+[[gnu::target("bmi2,adx")]] static inline Ge64P3 Ge64MAdd(
+    const Ge64P3& p, const Ge64Precomp& q)
+{
+    const Fe64 a = Fe64Mul(Fe64Sub(p.y, p.x), q.y_minus_x);
+    const Fe64 b = Fe64Mul(Fe64Add(p.y, p.x), q.y_plus_x);
+    const Fe64 c = Fe64Mul(p.t, q.xy2d);
+    const Fe64 d = Fe64Add(p.z, p.z);
+    const Fe64 e = Fe64Sub(b, a);
+    const Fe64 f = Fe64Sub(d, c);
+    const Fe64 g = Fe64Add(d, c);
+    const Fe64 h = Fe64Add(b, a);
+    return {Fe64Mul(e, f), Fe64Mul(g, h), Fe64Mul(f, g), Fe64Mul(e, h)};
+}
+
+/**
+ * @brief Point doubling, same formulas as GeDouble().
+ */
+[[gnu::target("bmi2,adx")]] static inline Ge64P3 Ge64Double(const Ge64P3& p)
+{
+    const Fe64 a = Fe64Sq(p.x);
+    const Fe64 b = Fe64Sq(p.y);
+    const Fe64 zz = Fe64Sq(p.z);
+    const Fe64 c = Fe64Add(zz, zz);
+    const Fe64 h = Fe64Add(a, b);
+    const Fe64 e = Fe64Sub(h, Fe64Sq(Fe64Add(p.x, p.y)));
+    const Fe64 g = Fe64Sub(a, b);
+    const Fe64 f = Fe64Add(c, g);
+    return {Fe64Mul(e, f), Fe64Mul(g, h), Fe64Mul(f, g), Fe64Mul(e, h)};
+}
+
+namespace ge_64
+{
+
+/**
+ * @brief Repacks a table entry selected in radix 2^51.
+ */
+static inline Ge64Precomp FromPrecomp(const GePrecomp& q)
+{
+    return {Fe64FromFe(q.y_plus_x), Fe64FromFe(q.y_minus_x),
+            Fe64FromFe(q.xy2d)};
+}
+
+/**
+ * @brief Shared body of GeScalarMultBase64() and GeScalarMultBase64Vartime().
+ *
+ * Entries are selected from the radix 2^51 table exactly like in
+ * GeScalarMultBase() and repacked, which costs a few shifts per addition
+ * and lets every engine share one table (and one cache file).
+ */
+template <bool VARTIME>
+[[gnu::target("bmi2,adx")]] static inline GeP3 ScalarMultBase(
+    std::span<const uint8_t, 32> a, const GeBaseTable& table)
+{
+    const auto& shape = table.Shape();
+    const auto e = GeRecodeScalar(a, shape.window);
+    const size_t digits = shape.Digits();
+
+    const Fe64 one = Fe64FromFe(FE_ONE);
+    Ge64P3 h{Fe64{}, one, one, Fe64{}};
+    for (size_t pass = shape.spacing; pass-- > 0;) {
+        for (size_t i = pass; i < digits; i += shape.spacing) {
+            const size_t row = i / shape.spacing;
+            if constexpr (VARTIME) {
+                if (e[i] != 0) {
+                    h = Ge64MAdd(
+                        h, FromPrecomp(GeSelectVartime(table, row, e[i])));
+                }
+            }
+            else {
+                h = Ge64MAdd(h, FromPrecomp(GeSelect(table, row, e[i])));
+            }
+        }
+        for (size_t k = 0; (pass > 0) and (k < shape.window); ++k) {
+            h = Ge64Double(h);
+        }
+    }
+    return {Fe64ToFe(h.x), Fe64ToFe(h.y), Fe64ToFe(h.z), Fe64ToFe(h.t)};
+}
+
+}  // namespace ge_64
+
+/**
+ * @brief Computes a * B like GeScalarMultBase(), with mulx/adx field
+ * arithmetic on 64-bit limbs.
+ *
+ * Constant time with respect to the scalar. Only call it when
+ * GetCpuFeatures() reports both BMI2 and ADX.
+ *
+ * @return the point in radix 2^51 extended coordinates
+ */
+[[gnu::target("bmi2,adx")]] static inline GeP3 GeScalarMultBase64(
+    std::span<const uint8_t, 32> a, const GeBaseTable& table = GetBaseTable())
+{
+    return ge_64::ScalarMultBase<false>(a, table);
+}
+
+/**
+ * @brief Same result as GeScalarMultBase64(), NOT constant time.
+ *
+ * Table entries are read directly by digit, see GeScalarMultBaseVartime().
+ */
+[[gnu::target("bmi2,adx")]] static inline GeP3 GeScalarMultBase64Vartime(
+    std::span<const uint8_t, 32> a, const GeBaseTable& table = GetBaseTable())
+{
+    return ge_64::ScalarMultBase<true>(a, table);
+}
+
+}  // namespace yggdrasil_cpp_genkeys
+
+#endif
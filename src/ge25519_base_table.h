@@ -0,0 +1,472 @@
+/**
+ * @file ge25519_base_table.h
+ * @brief Configurable base point tables and fixed-base scalar multiplication
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fe25519.h"
+#include "ge25519.h"
+#include "table_cache.h"
+#include "table_storage.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Window width range accepted by GeTableShape
+constexpr uint GE_TABLE_MIN_WINDOW = 2;
+constexpr uint GE_TABLE_MAX_WINDOW = 12;
+/// Spacing range accepted by GeTableShape
+constexpr uint GE_TABLE_MIN_SPACING = 1;
+constexpr uint GE_TABLE_MAX_SPACING = 8;
+
+/**
+ * @brief Layout of a fixed-base comb table.
+ *
+ * The scalar is recoded into Digits() signed digits of @c window bits,
+ * e[i] in [-2^(window-1), 2^(window-1)]. Digit i is served by table row
+ * i / spacing, which holds k * 2^(window * spacing * row) * B for
+ * k = 1..2^(window-1). The digits of a multiplication are consumed in
+ * @c spacing passes with @c window doublings between passes.
+ *
+ * Wider windows mean fewer point additions per key, fewer rows (larger
+ * spacing) mean a smaller table at the cost of more doublings. The default
+ * window 4, spacing 2 is the classic ref10 table (32 rows of 8 entries,
+ * 64 additions and 4 doublings).
+ */
+struct GeTableShape
+{
+    uint window = 4;   ///< digit width in bits
+    uint spacing = 2;  ///< digits sharing one table row
+
+    bool operator==(const GeTableShape&) const = default;
+
+    [[nodiscard]] bool IsValid() const
+    {
+        return (window >= GE_TABLE_MIN_WINDOW) and
+               (window <= GE_TABLE_MAX_WINDOW) and
+               (spacing >= GE_TABLE_MIN_SPACING) and
+               (spacing <= GE_TABLE_MAX_SPACING);
+    }
+
+    /// Number of signed digits of a scalar below 2^255
+    [[nodiscard]] size_t Digits() const { return (255 / window) + 1; }
+
+    [[nodiscard]] size_t Rows() const
+    {
+        return (Digits() + spacing - 1) / spacing;
+    }
+
+    [[nodiscard]] size_t RowSize() const { return size_t{1} << (window - 1); }
+
+    [[nodiscard]] size_t Bytes() const
+    {
+        return Rows() * RowSize() * sizeof(GePrecomp);
+    }
+};
+
+/**
+ * @brief Where base tables live in memory and on disk.
+ */
+struct GeTableStorageOptions
+{
+    std::filesystem::path cache_dir;  ///< table cache, empty to always compute
+    bool huge_pages = true;           ///< put computed tables on 2 MiB pages
+};
+
+/// Signed digits of a scalar, the first GeTableShape::Digits() are used
+using GeDigits = std::array<int16_t, 128>;
+
+/**
+ * @brief Precomputed multiples of the base point for one GeTableShape.
+ *
+ * Entries are affine (y + x, y - x, 2dxy) in radix 2^51, stored row by row.
+ * The table is computed on construction instead of being shipped as a
+ * constant blob. With a cache directory it is mapped read-only from a cache
+ * file written by an earlier run, or written there after being computed.
+ * The checksum of a cache file only guards against corruption, so a mapped
+ * table is also spot-checked against a few freshly computed entries and
+ * recomputed if any differs.
+ */
+class GeBaseTable
+{
+   public:
+    /**
+     * @param shape table layout, must be valid
+     * @param options cache directory and page size of the table memory
+     */
+    explicit GeBaseTable(const GeTableShape& shape,
+                         const GeTableStorageOptions& options = {})
+        : shape_(shape)
+    {
+        const auto& cache_dir = options.cache_dir;
+        const size_t count = shape.Rows() * shape.RowSize();
+        const std::string layout = std::format(
+            "ge25519 comb w={} s={} r51", shape.window, shape.spacing);
+        std::filesystem::path path;
+        bool rejected = false;
+        if (not cache_dir.empty()) {
+            path = cache_dir / std::format("ge25519-base-w{}-s{}.tbl",
+                                           shape.window, shape.spacing);
+            auto mapped = LoadTableCache(path, layout, shape.Bytes());
+            if (mapped.has_value()) {
+                const std::span<const GePrecomp> entries(
+                    reinterpret_cast<const GePrecomp*>(
+                        mapped->Bytes().data() + sizeof(TableCacheHeader)),
+                    count);
+                if (SpotCheck(shape, entries)) {
+                    storage_ = std::move(*mapped);
+                    entries_ = entries;
+                    origin_ = "mapped from " + path.string();
+                    return;
+                }
+                rejected = true;
+            }
+        }
+
+        storage_ = TableStorage::Allocate(shape.Bytes(), options.huge_pages);
+        const std::span<GePrecomp> entries(
+            reinterpret_cast<GePrecomp*>(storage_.Writable().data()), count);
+        Compute(shape, entries);
+        entries_ = entries;
+        origin_ = rejected ? "recomputed, cached entries were wrong" : "computed";
+        if (not path.empty()) {
+            origin_ += SaveTableCache(path, layout, storage_.Bytes())
+                           ? ", cached to " + path.string()
+                           : ", cache not writable";
+        }
+        storage_.Seal();
+    }
+
+    [[nodiscard]] const GeTableShape& Shape() const { return shape_; }
+
+    /**
+     * @brief Where the entries came from, for the startup log.
+     */
+    [[nodiscard]] const std::string& Origin() const { return origin_; }
+
+    /**
+     * @brief Page size backing the entries, for the startup log.
+     */
+    [[nodiscard]] std::string Pages() const { return storage_.DescribePages(); }
+
+    /**
+     * @brief Entries k * 2^(window * spacing * row) * B, k = 1..RowSize().
+     */
+    [[nodiscard]] std::span<const GePrecomp> Row(size_t row) const
+    {
+        return entries_.subspan(row * shape_.RowSize(), shape_.RowSize());
+    }
+
+   private:
+    GeTableShape shape_;
+    TableStorage storage_;                ///< built or mapped memory
+    std::span<const GePrecomp> entries_;  ///< entries inside storage_
+    std::string origin_;
+
+    static void Compute(const GeTableShape& shape,
+                        std::span<GePrecomp> entries)
+    {
+        const size_t row_size = shape.RowSize();
+
+        std::vector<GeP3> points;
+        points.reserve(entries.size());
+        GeP3 row_base = GE_BASE;
+        for (size_t i = 0; i < shape.Rows(); ++i) {
+            GeP3 multiple = row_base;
+            for (size_t j = 0; j < row_size; ++j) {
+                points.push_back(multiple);
+                multiple = GeAdd(multiple, row_base);
+            }
+            for (size_t k = 0; k < shape.window * shape.spacing; ++k) {
+                row_base = GeDouble(row_base);
+            }
+        }
+
+        std::vector<Fe25519> z_inv(points.size());
+        std::vector<Fe25519> scratch(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            z_inv[i] = points[i].z;
+        }
+        FeBatchInvert(z_inv, scratch);
+
+        for (size_t i = 0; i < points.size(); ++i) {
+            entries[i] = ToPrecomp(points[i], z_inv[i]);
+        }
+    }
+
+    /**
+     * @brief Compares the first entry of every row and 2B with freshly
+     * computed values.
+     *
+     * Costs one doubling chain and a batch inversion, far less than Compute().
+     */
+    static bool SpotCheck(const GeTableShape& shape,
+                          std::span<const GePrecomp> entries)
+    {
+        const size_t row_size = shape.RowSize();
+
+        std::vector<GeP3> points;
+        std::vector<size_t> indices;
+        points.reserve(shape.Rows() + 1);
+        indices.reserve(shape.Rows() + 1);
+        GeP3 row_base = GE_BASE;
+        for (size_t i = 0; i < shape.Rows(); ++i) {
+            points.push_back(row_base);
+            indices.push_back(i * row_size);
+            for (size_t k = 0; k < shape.window * shape.spacing; ++k) {
+                row_base = GeDouble(row_base);
+            }
+        }
+        points.push_back(GeDouble(GE_BASE));
+        indices.push_back(1);
+
+        std::vector<Fe25519> z_inv(points.size());
+        std::vector<Fe25519> scratch(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            z_inv[i] = points[i].z;
+        }
+        FeBatchInvert(z_inv, scratch);
+
+        const auto equal = [](const Fe25519& f, const Fe25519& g) {
+            return FeToBytes(f) == FeToBytes(g);
+        };
+        for (size_t i = 0; i < points.size(); ++i) {
+            const GePrecomp expected = ToPrecomp(points[i], z_inv[i]);
+            const GePrecomp& entry = entries[indices[i]];
+            if (not(equal(entry.y_plus_x, expected.y_plus_x) and
+                    equal(entry.y_minus_x, expected.y_minus_x) and
+                    equal(entry.xy2d, expected.xy2d))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Affine (y + x, y - x, 2dxy) of @p p, given 1/z
+    static GePrecomp ToPrecomp(const GeP3& p, const Fe25519& z_inv)
+    {
+        const Fe25519 x = FeMul(p.x, z_inv);
+        const Fe25519 y = FeMul(p.y, z_inv);
+        GePrecomp entry;
+        entry.y_plus_x =
+            FeCarry(y.v[0] + x.v[0], y.v[1] + x.v[1], y.v[2] + x.v[2],
+                    y.v[3] + x.v[3], y.v[4] + x.v[4]);
+        const Fe25519 y_minus_x = FeSub(y, x);
+        entry.y_minus_x = FeCarry(y_minus_x.v[0], y_minus_x.v[1],
+                                  y_minus_x.v[2], y_minus_x.v[3],
+                                  y_minus_x.v[4]);
+        entry.xy2d = FeMul(FeMul(x, y), FE_D2);
+        return entry;
+    }
+};
+
+namespace ge_table
+{
+
+/**
+ * @brief Process-wide tables by shape and the cache directory they use.
+ */
+struct Registry
+{
+    std::mutex mutex;
+    GeTableStorageOptions options;
+    std::map<std::pair<uint, uint>, std::unique_ptr<GeBaseTable>> tables;
+};
+
+inline Registry& GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+}  // namespace ge_table
+
+/**
+ * @brief Sets the storage options of the tables built by GetBaseTable().
+ *
+ * Only affects tables that have not been requested yet, so it is meant to
+ * be called once at startup. By default there is no cache directory.
+ */
+static inline void SetBaseTableStorage(const GeTableStorageOptions& options)
+{
+    auto& registry = ge_table::GetRegistry();
+    const std::lock_guard locker(registry.mutex);
+    registry.options = options;
+}
+
+/**
+ * @brief Returns the shared table of the given shape, built on first use.
+ *
+ * Tables are never freed, so references stay valid for the whole run.
+ * Thread-safe.
+ */
+static inline const GeBaseTable& GetBaseTable(const GeTableShape& shape = {})
+{
+    auto& registry = ge_table::GetRegistry();
+    const std::lock_guard locker(registry.mutex);
+    auto& table = registry.tables[{shape.window, shape.spacing}];
+    if (table == nullptr) {
+        table = std::make_unique<GeBaseTable>(shape, registry.options);
+    }
+    return *table;
+}
+
+/**
+ * @brief Recodes a scalar with a[31] <= 127 into signed window-bit digits.
+ *
+ * a = sum(e[i] * 2^(window * i)) with every e[i] in
+ * [-2^(window-1), 2^(window-1)]. The top digit covers less than @p window
+ * bits, so it stays in range after absorbing the last carry.
+ */
+static inline GeDigits GeRecodeScalar(std::span<const uint8_t, 32> a,
+                                      uint window)
+{
+    const size_t digits = (255 / window) + 1;
+    const int half = 1 << (window - 1);
+
+    GeDigits e{};
+    int carry = 0;
+    for (size_t i = 0; i < digits; ++i) {
+        // window <= 12 bits starting at bit, spread over at most 3 bytes
+        const size_t bit = i * window;
+        uint32_t bits = 0;
+        for (size_t j = 0; j < 3; ++j) {
+            const size_t byte = (bit / 8) + j;
+            if (byte < a.size()) {
+                bits |= static_cast<uint32_t>(a[byte]) << (8 * j);
+            }
+        }
+        const uint32_t mask = (1U << window) - 1;
+        int digit = static_cast<int>((bits >> (bit % 8)) & mask) + carry;
+        if (i + 1 < digits) {
+            carry = (digit + half) >> window;
+            digit -= carry << window;
+        }
+        e[i] = static_cast<int16_t>(digit);
+    }
+    return e;
+}
+
+/**
+ * @brief Constant-time selection of b * 2^(window * spacing * row) * B.
+ *
+ * Every entry of the row is visited, so memory access does not depend on
+ * the digit.
+ *
+ * @param b signed digit in [-RowSize(), RowSize()]
+ */
+static inline GePrecomp GeSelect(const GeBaseTable& table, size_t row,
+                                 int16_t b)
+{
+    const auto entries = table.Row(row);
+    const int sign = b >> 15;  // all ones for negative digits
+    const auto negative = static_cast<uint64_t>(sign & 1);
+    const auto b_abs = static_cast<uint64_t>((b ^ sign) - sign);
+
+    GePrecomp t{FE_ONE, FE_ONE, FE_ZERO};
+    for (size_t j = 0; j < entries.size(); ++j) {
+        // 1 iff b_abs == j + 1, without branches
+        const uint64_t equal = ((b_abs ^ (j + 1)) - 1) >> 63;
+        FeCMov(t.y_plus_x, entries[j].y_plus_x, equal);
+        FeCMov(t.y_minus_x, entries[j].y_minus_x, equal);
+        FeCMov(t.xy2d, entries[j].xy2d, equal);
+    }
+
+    // -(x, y) = (-x, y): swap y + x with y - x and negate 2dxy
+    const GePrecomp minus_t{t.y_minus_x, t.y_plus_x, FeNeg(t.xy2d)};
+    FeCMov(t.y_plus_x, minus_t.y_plus_x, negative);
+    FeCMov(t.y_minus_x, minus_t.y_minus_x, negative);
+    FeCMov(t.xy2d, minus_t.xy2d, negative);
+    return t;
+}
+
+/**
+ * @brief Variable-time lookup of b * 2^(window * spacing * row) * B.
+ *
+ * Reads exactly one table entry, so the accessed address depends on the
+ * digit, which must not be zero. Only for GeScalarMultBaseVartime().
+ */
+static inline GePrecomp GeSelectVartime(const GeBaseTable& table, size_t row,
+                                        int16_t b)
+{
+    const auto index = static_cast<size_t>(std::abs(b)) - 1;
+    const auto& entry = table.Row(row)[index];
+    if (b > 0) {
+        return entry;
+    }
+    return {entry.y_minus_x, entry.y_plus_x, FeNeg(entry.xy2d)};
+}
+
+/**
+ * @brief Computes a * B for a 256-bit little-endian scalar with a[31] <= 127.
+ *
+ * The scalar is recoded into signed digits of the table's window width.
+ * The digits sharing a row are accumulated in @c spacing passes from the
+ * most significant one down, each pass shifted by the next with @c window
+ * doublings (for the default table: odd nibbles, 4 doublings, even
+ * nibbles). Runs in constant time with respect to the scalar.
+ */
+static inline GeP3 GeScalarMultBase(std::span<const uint8_t, 32> a,
+                                    const GeBaseTable& table = GetBaseTable())
+{
+    const auto& shape = table.Shape();
+    const auto e = GeRecodeScalar(a, shape.window);
+    const size_t digits = shape.Digits();
+
+    GeP3 h = GE_IDENTITY;
+    for (size_t pass = shape.spacing; pass-- > 0;) {
+        for (size_t i = pass; i < digits; i += shape.spacing) {
+            h = GeMAdd(h, GeSelect(table, i / shape.spacing, e[i]));
+        }
+        for (size_t k = 0; (pass > 0) and (k < shape.window); ++k) {
+            h = GeDouble(h);
+        }
+    }
+    return h;
+}
+
+/**
+ * @brief Same result as GeScalarMultBase(), NOT constant time.
+ *
+ * Table entries are indexed directly by the digits and zero digits skip
+ * their addition, so both the memory access pattern and the running time
+ * leak the scalar. Only for hosts where timing side channels are outside
+ * the threat model.
+ */
+static inline GeP3 GeScalarMultBaseVartime(
+    std::span<const uint8_t, 32> a, const GeBaseTable& table = GetBaseTable())
+{
+    const auto& shape = table.Shape();
+    const auto e = GeRecodeScalar(a, shape.window);
+    const size_t digits = shape.Digits();
+
+    GeP3 h = GE_IDENTITY;
+    for (size_t pass = shape.spacing; pass-- > 0;) {
+        for (size_t i = pass; i < digits; i += shape.spacing) {
+            if (e[i] != 0) {
+                h = GeMAdd(h, GeSelectVartime(table, i / shape.spacing, e[i]));
+            }
+        }
+        for (size_t k = 0; (pass > 0) and (k < shape.window); ++k) {
+            h = GeDouble(h);
+        }
+    }
+    return h;
+}
+
+}  // namespace yggdrasil_cpp_genkeys
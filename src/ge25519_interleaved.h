@@ -0,0 +1,227 @@
+/**
+ * @file ge25519_interleaved.h
+ * @brief Ed25519 fixed-base scalar multiplications advanced in lockstep
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "fe25519.h"
+#include "ge25519.h"
+#include "ge25519_base_table.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Largest number of scalar multiplications worth interleaving
+constexpr size_t GE_MAX_INTERLEAVE = 4;
+
+namespace ge_interleaved
+{
+
+/// Field elements of one formula step, one per interleaved point
+template <size_t N>
+using Fes = std::array<Fe25519, N>;
+
+/**
+ * @brief Last step shared by addition and doubling:
+ * p = (e * f, g * h, f * g, e * h).
+ */
+template <size_t N>
+static inline void Finish(std::array<GeP3, N>& p, const Fes<N>& e,
+                          const Fes<N>& f, const Fes<N>& g, const Fes<N>& h)
+{
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        p[l].x = FeMul(e[l], f[l]);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        p[l].y = FeMul(g[l], h[l]);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        p[l].z = FeMul(f[l], g[l]);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        p[l].t = FeMul(e[l], h[l]);
+    }
+}
+
+}  // namespace ge_interleaved
+
+/**
+ * @brief Mixed additions p[l] + q[l] of N independent points.
+ *
+ * Same formulas as GeMAdd(), but each field operation is issued for all
+ * points before the next one starts. One point alone is a chain of
+ * dependent multiplications; with N of them the out-of-order core always
+ * has N independent ones to overlap.
+ */
+template <size_t N>
+static inline void GeMAddInterleaved(std::array<GeP3, N>& p,
+                                     const std::array<GePrecomp, N>& q)
+{
+    ge_interleaved::Fes<N> a;
+    ge_interleaved::Fes<N> b;
+    ge_interleaved::Fes<N> c;
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        a[l] = FeMul(FeSub(p[l].y, p[l].x), q[l].y_minus_x);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        b[l] = FeMul(FeAdd(p[l].y, p[l].x), q[l].y_plus_x);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        c[l] = FeMul(p[l].t, q[l].xy2d);
+    }
+
+    ge_interleaved::Fes<N> e;
+    ge_interleaved::Fes<N> f;
+    ge_interleaved::Fes<N> g;
+    ge_interleaved::Fes<N> h;
+    for (size_t l = 0; l < N; ++l) {
+        const Fe25519 d = FeAdd(p[l].z, p[l].z);
+        e[l] = FeSub(b[l], a[l]);
+        f[l] = FeSub(d, c[l]);
+        g[l] = FeAdd(d, c[l]);
+        h[l] = FeAdd(b[l], a[l]);
+    }
+    ge_interleaved::Finish(p, e, f, g, h);
+}
+
+/**
+ * @brief Doublings 2 * p[l] of N independent points, see GeDouble().
+ */
+template <size_t N>
+static inline void GeDoubleInterleaved(std::array<GeP3, N>& p)
+{
+    ge_interleaved::Fes<N> a;
+    ge_interleaved::Fes<N> b;
+    ge_interleaved::Fes<N> zz;
+    ge_interleaved::Fes<N> s;
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        a[l] = FeSq(p[l].x);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        b[l] = FeSq(p[l].y);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        zz[l] = FeSq(p[l].z);
+    }
+#pragma GCC unroll 4
+    for (size_t l = 0; l < N; ++l) {
+        s[l] = FeSq(FeAdd(p[l].x, p[l].y));
+    }
+
+    ge_interleaved::Fes<N> e;
+    ge_interleaved::Fes<N> f;
+    ge_interleaved::Fes<N> g;
+    ge_interleaved::Fes<N> h;
+    for (size_t l = 0; l < N; ++l) {
+        const Fe25519 c = FeAdd(zz[l], zz[l]);
+        h[l] = FeAdd(a[l], b[l]);
+        e[l] = FeSub(h[l], s[l]);
+        g[l] = FeSub(a[l], b[l]);
+        f[l] = FeAdd(c, g[l]);
+    }
+    ge_interleaved::Finish(p, e, f, g, h);
+}
+
+namespace ge_interleaved
+{
+
+/**
+ * @brief Shared body of GeScalarMultBaseInterleaved() and
+ * GeScalarMultBaseInterleavedVartime().
+ *
+ * The vartime variant cannot skip zero digits of one point without
+ * breaking the lockstep, so it adds the neutral element instead.
+ */
+template <size_t N, bool VARTIME>
+static inline void ScalarMultBase(
+    const std::array<std::array<uint8_t, 32>, N>& a,
+    const std::array<GeP3*, N>& out, const GeBaseTable& table)
+{
+    const auto& shape = table.Shape();
+    const size_t digits = shape.Digits();
+
+    std::array<GeDigits, N> e;
+    for (size_t l = 0; l < N; ++l) {
+        e[l] = GeRecodeScalar(a[l], shape.window);
+    }
+
+    std::array<GeP3, N> h;
+    h.fill(GE_IDENTITY);
+    std::array<GePrecomp, N> q;
+    for (size_t pass = shape.spacing; pass-- > 0;) {
+        for (size_t i = pass; i < digits; i += shape.spacing) {
+            const size_t row = i / shape.spacing;
+            for (size_t l = 0; l < N; ++l) {
+                if constexpr (VARTIME) {
+                    q[l] = (e[l][i] == 0)
+                               ? GePrecomp{FE_ONE, FE_ONE, FE_ZERO}
+                               : GeSelectVartime(table, row, e[l][i]);
+                }
+                else {
+                    q[l] = GeSelect(table, row, e[l][i]);
+                }
+            }
+            GeMAddInterleaved(h, q);
+        }
+        for (size_t k = 0; (pass > 0) and (k < shape.window); ++k) {
+            GeDoubleInterleaved(h);
+        }
+    }
+
+    for (size_t l = 0; l < N; ++l) {
+        *out[l] = h[l];
+    }
+}
+
+}  // namespace ge_interleaved
+
+/**
+ * @brief Computes a[l] * B for N scalars with interleaved field operations.
+ *
+ * Same signed-digit recoding and table walk as GeScalarMultBase() on plain
+ * 64-bit integer arithmetic, so it needs no vector unit; instruction-level
+ * parallelism comes from the N independent points instead. Constant time
+ * with respect to the scalars.
+ *
+ * @param a N 256-bit little-endian scalars with a[31] <= 127
+ * @param out resulting points
+ * @param table base table to walk
+ */
+template <size_t N>
+static inline void GeScalarMultBaseInterleaved(
+    const std::array<std::array<uint8_t, 32>, N>& a,
+    const std::array<GeP3*, N>& out, const GeBaseTable& table = GetBaseTable())
+{
+    ge_interleaved::ScalarMultBase<N, false>(a, out, table);
+}
+
+/**
+ * @brief Same result as GeScalarMultBaseInterleaved(), NOT constant time.
+ *
+ * Table entries are read directly by digit, see GeScalarMultBaseVartime().
+ */
+template <size_t N>
+static inline void GeScalarMultBaseInterleavedVartime(
+    const std::array<std::array<uint8_t, 32>, N>& a,
+    const std::array<GeP3*, N>& out, const GeBaseTable& table = GetBaseTable())
+{
+    ge_interleaved::ScalarMultBase<N, true>(a, out, table);
+}
+
+}  // namespace yggdrasil_cpp_genkeys
@@ -0,0 +1,311 @@
+/**
+ * @file ge25519_x4.h
+ * @brief Four-way AVX2 Ed25519 fixed-base scalar multiplication
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+
+#include "fe25519_x4.h"
+#include "ge25519.h"
+#include "ge25519_base_table.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Number of scalar multiplications run by one GeScalarMultBaseX4() call
+constexpr size_t GE_X4_LANES = 4;
+
+/**
+ * @brief Four extended points, one per AVX2 lane.
+ */
+struct GeX4P3
+{
+    FeX4 x;
+    FeX4 y;
+    FeX4 z;
+    FeX4 t;
+};
+
+/**
+ * @brief Four affine precomputed points, one per AVX2 lane.
+ */
+struct GeX4Precomp
+{
+    FeX4 y_plus_x;
+    FeX4 y_minus_x;
+    FeX4 xy2d;
+};
+
+namespace ge_x4
+{
+
+/**
+ * @brief Replaces the lanes of @p acc selected by @p mask with @p limb.
+ */
+[[gnu::target("avx2")]] static inline __m256i BlendLimb(__m256i acc,
+                                                        uint64_t limb,
+                                                        __m256i mask)
+{
+    return _mm256_blendv_epi8(
+        acc, _mm256_set1_epi64x(static_cast<int64_t>(limb)), mask);
+}
+
+/**
+ * @brief Converts selected radix 2^51 entries and negates the masked lanes.
+ *
+ * -(x, y) = (-x, y): y + x is swapped with y - x and 2dxy is negated.
+ */
+[[gnu::target("avx2")]] static inline GeX4Precomp Finish(
+    const __m256i (&yp)[5],  // NOLINT(*-avoid-c-arrays)
+    const __m256i (&ym)[5],  // NOLINT(*-avoid-c-arrays)
+    const __m256i (&xy)[5],  // NOLINT(*-avoid-c-arrays)
+    __m256i negative)
+{
+    const FeX4 y_plus_x = FeX4FromLimbs51(yp);
+    const FeX4 y_minus_x = FeX4FromLimbs51(ym);
+    const FeX4 xy2d = FeX4FromLimbs51(xy);
+
+    FeX4 zero;
+    for (auto& limb : zero.v) {
+        limb = _mm256_setzero_si256();
+    }
+    return {FeX4Select(y_plus_x, y_minus_x, negative),
+            FeX4Select(y_minus_x, y_plus_x, negative),
+            FeX4Select(xy2d, FeX4Sub(zero, xy2d), negative)};
+}
+
+}  // namespace ge_x4
+
+/**
+ * @brief Mixed addition, same formulas as GeMAdd().
+ */
+[[gnu::target("avx2")]] static inline GeX4P3 GeX4MAdd(const GeX4P3& p,
+                                                      const GeX4Precomp& q)
+{
+    const FeX4 a = FeX4Mul(FeX4Sub(p.y, p.x), q.y_minus_x);
+    const FeX4 b = FeX4Mul(FeX4Add(p.y, p.x), q.y_plus_x);
+    const FeX4 c = FeX4Mul(p.t, q.xy2d);
+    const FeX4 d = FeX4Add(p.z, p.z);
+    const FeX4 e = FeX4Sub(b, a);
+    FeX4 f = FeX4Sub(d, c);
+    FeX4Carry(f);
+    const FeX4 g = FeX4Add(d, c);
+    const FeX4 h = FeX4Add(b, a);
+    return {FeX4Mul(e, f), FeX4Mul(g, h), FeX4Mul(f, g), FeX4Mul(e, h)};
+}
+
+/**
+ * @brief Point doubling, same formulas as GeDouble().
+ */
+[[gnu::target("avx2")]] static inline GeX4P3 GeX4Double(const GeX4P3& p)
+{
+    const FeX4 a = FeX4Mul(p.x, p.x);
+    const FeX4 b = FeX4Mul(p.y, p.y);
+    const FeX4 zz = FeX4Mul(p.z, p.z);
+    const FeX4 c = FeX4Add(zz, zz);
+    FeX4 h = FeX4Add(a, b);
+    FeX4Carry(h);
+    const FeX4 xy = FeX4Add(p.x, p.y);
+    const FeX4 e = FeX4Sub(h, FeX4Mul(xy, xy));
+    const FeX4 g = FeX4Sub(a, b);
+    FeX4 f = FeX4Add(c, g);
+    FeX4Carry(f);
+    return {FeX4Mul(e, f), FeX4Mul(g, h), FeX4Mul(f, g), FeX4Mul(e, h)};
+}
+
+/// Signed digits of the four lanes at one digit position
+using GeX4Digits = std::array<int16_t, GE_X4_LANES>;
+
+/**
+ * @brief Constant-time per-lane selection from row @p pos of the table.
+ *
+ * Every table entry of the row is visited and blended into the lanes whose
+ * digit matches, so memory access does not depend on the digits.
+ *
+ * @param pos row of the base table
+ * @param b signed digits in [-RowSize(), RowSize()], one per lane
+ */
+[[gnu::target("avx2")]] static inline GeX4Precomp GeX4Select(
+    const GeBaseTable& table, size_t pos, const GeX4Digits& b)
+{
+    const auto row = table.Row(pos);
+
+    std::array<int64_t, GE_X4_LANES> abs_digits{};
+    std::array<int64_t, GE_X4_LANES> signs{};
+    for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+        const int64_t digit = b[lane];
+        signs[lane] = digit >> 63;  // all ones for negative digits
+        abs_digits[lane] = (digit ^ signs[lane]) - signs[lane];
+    }
+    const __m256i b_abs = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(abs_digits.data()));
+    const __m256i negative =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(signs.data()));
+
+    // blend in radix 2^51 first, 15 limbs per entry instead of 30
+    __m256i yp[5];  // NOLINT(*-avoid-c-arrays)
+    __m256i ym[5];  // NOLINT(*-avoid-c-arrays)
+    __m256i xy[5];  // NOLINT(*-avoid-c-arrays)
+    for (size_t k = 0; k < 5; ++k) {
+        yp[k] = _mm256_set1_epi64x(static_cast<int64_t>(FE_ONE.v[k]));
+        ym[k] = yp[k];
+        xy[k] = _mm256_setzero_si256();
+    }
+    for (size_t j = 0; j < row.size(); ++j) {
+        const __m256i equal = _mm256_cmpeq_epi64(
+            b_abs, _mm256_set1_epi64x(static_cast<int64_t>(j + 1)));
+        const auto& entry = row[j];
+        for (size_t k = 0; k < 5; ++k) {
+            yp[k] = ge_x4::BlendLimb(yp[k], entry.y_plus_x.v[k], equal);
+            ym[k] = ge_x4::BlendLimb(ym[k], entry.y_minus_x.v[k], equal);
+            xy[k] = ge_x4::BlendLimb(xy[k], entry.xy2d.v[k], equal);
+        }
+    }
+
+    return ge_x4::Finish(yp, ym, xy, negative);
+}
+
+/**
+ * @brief Variable-time per-lane lookup from row @p pos of the table.
+ *
+ * Gathers one table entry per lane (the neutral element for zero digits),
+ * so the accessed addresses depend on the digits. Only for
+ * GeScalarMultBaseX4Vartime().
+ */
+[[gnu::target("avx2")]] static inline GeX4Precomp GeX4SelectVartime(
+    const GeBaseTable& table, size_t pos, const GeX4Digits& b)
+{
+    static_assert(sizeof(GePrecomp) == 15 * sizeof(uint64_t));
+    const auto* row =
+        reinterpret_cast<const long long*>(table.Row(pos).data());
+
+    std::array<int64_t, GE_X4_LANES> offsets{};
+    std::array<int64_t, GE_X4_LANES> zeros{};
+    std::array<int64_t, GE_X4_LANES> signs{};
+    for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+        const int digit = b[lane];
+        offsets[lane] = (digit == 0) ? 0 : 15 * (std::abs(digit) - 1);
+        zeros[lane] = (digit == 0) ? -1 : 0;
+        signs[lane] = (digit < 0) ? -1 : 0;
+    }
+    const __m256i index =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets.data()));
+    const __m256i zero =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(zeros.data()));
+    const __m256i negative =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(signs.data()));
+
+    // one gather per limb, lanes with a zero digit get the neutral element
+    __m256i yp[5];  // NOLINT(*-avoid-c-arrays)
+    __m256i ym[5];  // NOLINT(*-avoid-c-arrays)
+    __m256i xy[5];  // NOLINT(*-avoid-c-arrays)
+    for (size_t k = 0; k < 5; ++k) {
+        yp[k] = ge_x4::BlendLimb(_mm256_i64gather_epi64(row + k, index, 8),
+                                 FE_ONE.v[k], zero);
+        ym[k] = ge_x4::BlendLimb(_mm256_i64gather_epi64(row + 5 + k, index, 8),
+                                 FE_ONE.v[k], zero);
+        xy[k] = _mm256_andnot_si256(
+            zero, _mm256_i64gather_epi64(row + 10 + k, index, 8));
+    }
+
+    return ge_x4::Finish(yp, ym, xy, negative);
+}
+
+namespace ge_x4
+{
+
+template <bool VARTIME>
+[[gnu::target("avx2")]] static inline GeX4Precomp Select(
+    const GeBaseTable& table, size_t pos, const GeX4Digits& b)
+{
+    if constexpr (VARTIME) {
+        return GeX4SelectVartime(table, pos, b);
+    }
+    else {
+        return GeX4Select(table, pos, b);
+    }
+}
+
+/**
+ * @brief Shared body of GeScalarMultBaseX4() and GeScalarMultBaseX4Vartime().
+ */
+template <bool VARTIME>
+[[gnu::target("avx2")]] static inline void ScalarMultBase(
+    const std::array<std::span<const uint8_t, 32>, GE_X4_LANES>& a,
+    std::array<GeP3*, GE_X4_LANES>& out, const GeBaseTable& table)
+{
+    const auto& shape = table.Shape();
+    const size_t digits = shape.Digits();
+
+    std::array<GeX4Digits, std::tuple_size_v<GeDigits>> e{};
+    for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+        const auto lane_digits = GeRecodeScalar(a[lane], shape.window);
+        for (size_t i = 0; i < digits; ++i) {
+            e[i][lane] = lane_digits[i];
+        }
+    }
+
+    GeX4P3 h{FeX4Broadcast(FE_ZERO), FeX4Broadcast(FE_ONE),
+             FeX4Broadcast(FE_ONE), FeX4Broadcast(FE_ZERO)};
+    for (size_t pass = shape.spacing; pass-- > 0;) {
+        for (size_t i = pass; i < digits; i += shape.spacing) {
+            h = GeX4MAdd(h, Select<VARTIME>(table, i / shape.spacing, e[i]));
+        }
+        for (size_t k = 0; (pass > 0) and (k < shape.window); ++k) {
+            h = GeX4Double(h);
+        }
+    }
+
+    for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+        *out[lane] = {FeX4Extract(h.x, lane), FeX4Extract(h.y, lane),
+                      FeX4Extract(h.z, lane), FeX4Extract(h.t, lane)};
+    }
+}
+
+}  // namespace ge_x4
+
+/**
+ * @brief Computes a[lane] * B for four scalars at once.
+ *
+ * Same signed-digit recoding and table walk as GeScalarMultBase(), with the
+ * field arithmetic of the four multiplications running in parallel AVX2
+ * lanes. Constant time with respect to the scalars.
+ *
+ * @param a four 256-bit little-endian scalars with a[31] <= 127
+ * @param out resulting points in radix 2^51 extended coordinates
+ * @param table base table to walk
+ */
+[[gnu::target("avx2")]] static inline void GeScalarMultBaseX4(
+    const std::array<std::span<const uint8_t, 32>, GE_X4_LANES>& a,
+    std::array<GeP3*, GE_X4_LANES>& out,
+    const GeBaseTable& table = GetBaseTable())
+{
+    ge_x4::ScalarMultBase<false>(a, out, table);
+}
+
+/**
+ * @brief Same result as GeScalarMultBaseX4(), NOT constant time.
+ *
+ * Table entries are read directly by digit, see GeScalarMultBaseVartime().
+ */
+[[gnu::target("avx2")]] static inline void GeScalarMultBaseX4Vartime(
+    const std::array<std::span<const uint8_t, 32>, GE_X4_LANES>& a,
+    std::array<GeP3*, GE_X4_LANES>& out,
+    const GeBaseTable& table = GetBaseTable())
+{
+    ge_x4::ScalarMultBase<true>(a, out, table);
+}
+
+}  // namespace yggdrasil_cpp_genkeys
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file isa_dispatch.h
+ * @brief Hot kernels compiled once per x86-64 level and picked at runtime
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include "cpu_features.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+namespace isa_dispatch
+{
+
+/**
+ * @brief Entry point of a kernel compiled for one level.
+ *
+ * Run() is flattened: the kernel and everything it calls is inlined into it
+ * and so compiled for the level of the specialization. Functions marked
+ * noinline stay shared, and so do functions with their own target
+ * attribute that the level does not cover.
+ */
+template <IsaLevel LEVEL>
+struct Target;
+
+template <>
+struct Target<IsaLevel::V1>
+{
+    template <typename Kernel>
+    [[gnu::flatten]] static decltype(auto) Run(Kernel& kernel)
+    {
+        return kernel();
+    }
+};
+
+#if defined(__x86_64__)
+template <>
+struct Target<IsaLevel::V2>
+{
+    template <typename Kernel>
+    [[gnu::target("arch=x86-64-v2"), gnu::flatten]] static decltype(auto) Run(
+        Kernel& kernel)
+    {
+        return kernel();
+    }
+};
+
+template <>
+struct Target<IsaLevel::V3>
+{
+    template <typename Kernel>
+    [[gnu::target("arch=x86-64-v3"), gnu::flatten]] static decltype(auto) Run(
+        Kernel& kernel)
+    {
+        return kernel();
+    }
+};
+
+template <>
+struct Target<IsaLevel::V4>
+{
+    template <typename Kernel>
+    [[gnu::target("arch=x86-64-v4"), gnu::flatten]] static decltype(auto) Run(
+        Kernel& kernel)
+    {
+        return kernel();
+    }
+};
+#endif
+
+}  // namespace isa_dispatch
+
+/**
+ * @brief Runs @p kernel as compiled for @p level.
+ *
+ * Every call site instantiates the kernel for all levels, so one binary
+ * carries a variant per CPU generation without -march. Dispatch costs a
+ * switch, so kernels should cover a whole batch rather than a single key.
+ *
+ * @param level at most GetCpuFeatures().isa_level
+ * @param kernel callable without arguments
+ */
+template <typename Kernel>
+decltype(auto) RunForIsa([[maybe_unused]] IsaLevel level, Kernel&& kernel)
+{
+#if defined(__x86_64__)
+    switch (level) {
+        case IsaLevel::V4:
+            return isa_dispatch::Target<IsaLevel::V4>::Run(kernel);
+        case IsaLevel::V3:
+            return isa_dispatch::Target<IsaLevel::V3>::Run(kernel);
+        case IsaLevel::V2:
+            return isa_dispatch::Target<IsaLevel::V2>::Run(kernel);
+        case IsaLevel::V1:
+            break;
+    }
+#endif
+    return isa_dispatch::Target<IsaLevel::V1>::Run(kernel);
+}
+
+}  // namespace yggdrasil_cpp_genkeys
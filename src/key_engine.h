@@ -0,0 +1,317 @@
+/**
+ * @file key_engine.h
+ * @brief Interchangeable Ed25519 key derivation engines and their registry
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <sodium.h>  // libsodium reference implementation
+#ifdef __cplusplus
+}
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "cpu_features.h"
+#include "ed25519_batch_engine.h"
+#include "ed25519_keys.h"
+#include "ge25519_base_table.h"
+#include "isa_dispatch.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Engine name that selects the fastest engine by a startup calibration
+constexpr std::string_view KEY_ENGINE_AUTO = "auto";
+
+/**
+ * @brief Options shared by all engines.
+ */
+struct KeyEngineOptions
+{
+    bool unsafe_vartime = false;  ///< variable-time table lookups
+    GeTableShape table_shape{};   ///< fixed-base table layout
+    IsaLevel isa_level = GetCpuFeatures().isa_level;  ///< kernel variant
+};
+
+/**
+ * @brief Derives Ed25519 public keys for a batch of seeds.
+ *
+ * The worker loop only talks to this interface, so a faster derivation is a
+ * new engine in the registry below rather than a fork of the loop. Engines
+ * may ignore options they have no use for.
+ */
+class KeyEngine
+{
+   public:
+    KeyEngine() = default;
+    KeyEngine(const KeyEngine&) = delete;
+    KeyEngine& operator=(const KeyEngine&) = delete;
+    KeyEngine(KeyEngine&&) = delete;
+    KeyEngine& operator=(KeyEngine&&) = delete;
+    virtual ~KeyEngine() = default;
+
+    /**
+     * @brief Derives the public keys of the batch.
+     *
+     * Every byte a score looks at is final afterwards, but an engine may
+     * leave bit 255 of the public key and the secret key unset until
+     * Complete() is called for the key.
+     *
+     * @param batch key sets with the seed already filled in
+     */
+    virtual void GeneratePartial(std::span<Keys_t> batch) = 0;
+
+    /**
+     * @brief Finishes a key of the last GeneratePartial() batch.
+     *
+     * @param index position of the key in the batch
+     * @param keys the same key set that was passed at that position
+     */
+    virtual void Complete(size_t index, Keys_t& keys) = 0;
+
+    /**
+     * @brief Derives complete key pairs for the whole batch.
+     */
+    void Generate(std::span<Keys_t> batch)
+    {
+        GeneratePartial(batch);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Complete(i, batch[i]);
+        }
+    }
+};
+
+/**
+ * @brief One crypto_sign_ed25519_seed_keypair() call per key.
+ *
+ * The reference every other engine is checked against.
+ */
+class SodiumKeyEngine final : public KeyEngine
+{
+   public:
+    void GeneratePartial(std::span<Keys_t> batch) override
+    {
+        for (auto& keys : batch) {
+            [[maybe_unused]] const auto result =
+                crypto_sign_ed25519_seed_keypair(keys.public_key.data(),
+                                                 keys.secret_key.data(),
+                                                 keys.seed.data());
+            assert(result == 0);
+        }
+    }
+
+    void Complete(size_t /*index*/, Keys_t& /*keys*/) override {}
+};
+
+/**
+ * @brief Ed25519_BatchEngine with a chosen set of CPU-specific kernels.
+ *
+ * The whole batch derivation is compiled once per x86-64 level and runs in
+ * the variant of KeyEngineOptions::isa_level.
+ */
+class BatchKeyEngine final : public KeyEngine
+{
+   public:
+    /**
+     * @param simd use the AVX2 4-way kernels
+     * @param mulx use the BMI2/ADX scalar field arithmetic
+     * @param interleave scalar multiplications in lockstep (1, 2 or 4)
+     */
+    BatchKeyEngine(const KeyEngineOptions& options, bool simd, bool mulx,
+                   size_t interleave = 1)
+        : isa_level_(options.isa_level)
+    {
+        engine_.SetUnsafeVartime(options.unsafe_vartime);
+        engine_.SetTableShape(options.table_shape);
+        engine_.SetSimd(simd);
+        engine_.SetMulx(mulx);
+        engine_.SetInterleave(interleave);
+    }
+
+    void GeneratePartial(std::span<Keys_t> batch) override
+    {
+        RunForIsa(isa_level_,
+                  [this, batch] { engine_.GeneratePartial(batch); });
+    }
+
+    void Complete(size_t index, Keys_t& keys) override
+    {
+        engine_.Complete(index, keys);
+    }
+
+   private:
+    IsaLevel isa_level_;
+    Ed25519_BatchEngine engine_;
+};
+
+/**
+ * @brief Registry entry of a key engine.
+ */
+struct KeyEngineInfo
+{
+    std::string_view name;         ///< value of --engine
+    std::string_view description;  ///< one line for the help and the log
+    bool (*available)();           ///< whether the running CPU can use it
+    std::unique_ptr<KeyEngine> (*make)(const KeyEngineOptions&);
+};
+
+/**
+ * @brief All engines, from the reference to the most specialised one.
+ */
+inline std::span<const KeyEngineInfo> KeyEngines()
+{
+    static const std::array<KeyEngineInfo, 6> engines{{
+        {.name = "libsodium",
+         .description = "libsodium, one key at a time (reference)",
+         .available = [] { return true; },
+         .make = [](const KeyEngineOptions& /*options*/)
+             -> std::unique_ptr<KeyEngine> {
+             return std::make_unique<SodiumKeyEngine>();
+         }},
+        {.name = "batch",
+         .description = "batched, shared field inversion, portable",
+         .available = [] { return true; },
+         .make = [](const KeyEngineOptions& options)
+             -> std::unique_ptr<KeyEngine> {
+             return std::make_unique<BatchKeyEngine>(options, false, false);
+         }},
+        {.name = "batch-x2",
+         .description = "batched, two keys interleaved per core, portable",
+         .available = [] { return true; },
+         .make = [](const KeyEngineOptions& options)
+             -> std::unique_ptr<KeyEngine> {
+             return std::make_unique<BatchKeyEngine>(options, false, false,
+                                                     2);
+         }},
+        {.name = "batch-x4",
+         .description = "batched, four keys interleaved per core, portable",
+         .available = [] { return true; },
+         .make = [](const KeyEngineOptions& options)
+             -> std::unique_ptr<KeyEngine> {
+             return std::make_unique<BatchKeyEngine>(options, false, false,
+                                                     4);
+         }},
+        {.name = "batch-bmi2",
+         .description = "batched, mulx/adx arithmetic on 64-bit limbs",
+         .available = [] { return Ed25519_BatchEngine::MulxSupported(); },
+         .make = [](const KeyEngineOptions& options)
+             -> std::unique_ptr<KeyEngine> {
+             return std::make_unique<BatchKeyEngine>(options, false, true);
+         }},
+        {.name = "batch-avx2",
+         .description = "batched, four keys per AVX2 vector",
+         .available = [] { return GetCpuFeatures().avx2; },
+         .make = [](const KeyEngineOptions& options)
+             -> std::unique_ptr<KeyEngine> {
+             return std::make_unique<BatchKeyEngine>(options, true, true);
+         }},
+    }};
+    return engines;
+}
+
+/**
+ * @brief Looks up a registered engine by name.
+ *
+ * @return nullptr for unknown names
+ */
+inline const KeyEngineInfo* FindKeyEngine(std::string_view name)
+{
+    const auto engines = KeyEngines();
+    const auto it = std::ranges::find(engines, name, &KeyEngineInfo::name);
+    return (it == engines.end()) ? nullptr : &*it;
+}
+
+/**
+ * @brief Creates the engine @p name.
+ *
+ * @return nullptr if the engine is unknown or not available on this CPU
+ */
+inline std::unique_ptr<KeyEngine> MakeKeyEngine(
+    std::string_view name, const KeyEngineOptions& options = {})
+{
+    const auto* info = FindKeyEngine(name);
+    if ((info == nullptr) or not info->available()) {
+        return nullptr;
+    }
+    return info->make(options);
+}
+
+/**
+ * @brief Calibration result of one engine.
+ */
+struct KeyEngineRate
+{
+    std::string_view name;
+    double keys_per_second = 0;
+};
+
+/**
+ * @brief Measures the single-thread throughput of every available engine.
+ *
+ * Meant for a quick pick at startup: each engine generates batches of
+ * @p batch_size random seeds for about @p duration after one warm-up batch.
+ *
+ * @return rates in registry order
+ */
+inline std::vector<KeyEngineRate> CalibrateKeyEngines(
+    const KeyEngineOptions& options, std::chrono::nanoseconds duration,
+    size_t batch_size)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Keys_t> batch(batch_size);
+    for (auto& keys : batch) {
+        randombytes_buf(keys.seed.data(), keys.seed.size());
+    }
+
+    std::vector<KeyEngineRate> rates;
+    for (const auto& info : KeyEngines()) {
+        if (not info.available()) {
+            continue;
+        }
+        auto engine = info.make(options);
+        engine->GeneratePartial(batch);
+
+        size_t keys = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < duration) {
+            engine->GeneratePartial(batch);
+            keys += batch.size();
+            elapsed = Clock::now() - start;
+        }
+        rates.push_back(
+            {.name = info.name,
+             .keys_per_second =
+                 static_cast<double>(keys) /
+                 std::chrono::duration<double>(elapsed).count()});
+    }
+
+    sodium_memzero(batch.data(), batch.size() * sizeof(Keys_t));
+    return rates;
+}
+
+/**
+ * @brief Name of the fastest engine among calibration results.
+ */
+inline std::string_view FastestKeyEngine(std::span<const KeyEngineRate> rates)
+{
+    assert(not rates.empty());
+    return std::ranges::max_element(rates, {}, &KeyEngineRate::keys_per_second)
+        ->name;
+}
+
+}  // namespace yggdrasil_cpp_genkeys
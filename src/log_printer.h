@@ -0,0 +1,305 @@
+/**
+ * @file log_printer.h
+ * @brief Output formatted and written off the worker threads
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <sodium.h>  // libsodium for wiping rebuilt keys
+#ifdef __cplusplus
+}
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <memory>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "candidate.h"
+#include "common.h"
+#include "spsc_ring.h"
+#include "telemetry.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// How records are written to stdout
+enum class LogFormat : uint8_t
+{
+    Text,  ///< the human-readable lines
+    Json,  ///< one JSON object per line (NDJSON)
+};
+
+/**
+ * @brief Parses the value of --format.
+ */
+inline std::optional<LogFormat> ParseLogFormat(std::string_view name)
+{
+    if (name == "text") {
+        return LogFormat::Text;
+    }
+    if (name == "json") {
+        return LogFormat::Json;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief One line of output in binary form, fixed size.
+ *
+ * Keys travel as the seed of the candidate and are only rebuilt by the
+ * printer thread.
+ */
+struct LogRecord
+{
+    enum class Kind : uint8_t
+    {
+        NewBest,  ///< a worker found a new local best
+        Result,   ///< the manager has a new global best
+    };
+
+    Kind kind = Kind::NewBest;
+    uint32_t thread = 0;    ///< worker number, NewBest only
+    Candidate candidate;    ///< the key and its score
+    uint64_t elapsed_ns = 0;        ///< run time so far, Result only
+    TelemetrySnapshot telemetry;    ///< all workers, Result only
+    uint64_t queue_overflows = 0;   ///< candidate ring, Result only
+    std::chrono::steady_clock::time_point time;  ///< order of output
+};
+
+/**
+ * @brief Formats and writes the records of many threads on a thread of its
+ * own.
+ *
+ * Every producer gets an SPSC ring, so pushing a record is a copy and a
+ * release store: producers never take the stdout lock or wait on the
+ * terminal. The printer polls the rings, orders what it found by time and
+ * writes it in one go. A record pushed with try_push() is dropped if its
+ * ring is full and the count is reported on stderr when the printer stops;
+ * results are pushed with push(), which waits for the printer instead.
+ */
+class LogPrinter
+{
+   public:
+    /// Records one producer may have in flight
+    static constexpr size_t RING_CAPACITY = 64;
+    using Ring = SpscRing<LogRecord, RING_CAPACITY>;
+
+    /**
+     * @param producers number of rings, one per producing thread
+     * @param format output format
+     * @param verbose also print the statistics of Result records
+     */
+    LogPrinter(size_t producers, LogFormat format, bool verbose)
+        : format_(format), verbose_(verbose)
+    {
+        for (size_t i = 0; i < producers; ++i) {
+            rings_.push_back(std::make_unique<Ring>());
+        }
+    }
+
+    LogPrinter(const LogPrinter&) = delete;
+    LogPrinter& operator=(const LogPrinter&) = delete;
+    LogPrinter(LogPrinter&&) = delete;
+    LogPrinter& operator=(LogPrinter&&) = delete;
+
+    ~LogPrinter() { Stop(); }
+
+    /**
+     * @brief Ring of producer @p producer; only that thread may push.
+     */
+    Ring* RingFor(size_t producer) { return rings_.at(producer).get(); }
+
+    /**
+     * @brief Starts the printer thread.
+     */
+    void Start()
+    {
+        thread_ = std::jthread([this](std::stop_token stoken) {
+            constexpr auto POLL_PERIOD = std::chrono::milliseconds(5);
+            while (not stoken.stop_requested()) {
+                if (not Flush()) {
+                    std::this_thread::sleep_for(POLL_PERIOD);
+                }
+            }
+            while (Flush()) {
+            }
+        });
+    }
+
+    /**
+     * @brief Writes all pending records and stops the printer thread.
+     */
+    void Stop()
+    {
+        if (not thread_.joinable()) {
+            return;
+        }
+        thread_.request_stop();
+        thread_.join();
+
+        uint64_t drops = 0;
+        for (const auto& ring : rings_) {
+            drops += ring->Drops();
+        }
+        if (drops != 0) {
+            std::println(stderr, "{} log records dropped", drops);
+        }
+    }
+
+    /**
+     * @brief Formats one record as it is written, without line break.
+     */
+    static std::string Format(const LogRecord& record, LogFormat format,
+                              bool verbose)
+    {
+        auto keys = record.candidate.Materialize();
+        const auto pub = keys.public_key.ToHex();
+        const auto addr = AddrForKey(keys.public_key).ToString();
+        const auto priv = keys.secret_key.ToHex();
+        sodium_memzero(&keys, sizeof(keys));
+
+        const auto& c = record.candidate;
+        // the template of --pattern / --pattern-file the address matches
+        const auto target =
+            c.pattern_match ? std::format(R"(,"target":{})", c.target)
+                            : std::string();
+        if (record.kind == LogRecord::Kind::NewBest) {
+            if (format == LogFormat::Json) {
+                return std::format(
+                    R"({{"event":"new_best","thread":{},"zero_bits":{},)"
+                    R"("ipv6_zero_blocks":{}{},"public_key":"{}",)"
+                    R"("address":"{}"}})",
+                    record.thread, c.zero_bits, c.ipv6_zero_blocks, target,
+                    pub, addr);
+            }
+            return std::format("    thread {:3}: new best z={:2} | pub={} | "
+                               "ip={}",
+                               record.thread, c.zero_bits, pub, addr);
+        }
+
+        const std::chrono::duration<double> duration =
+            std::chrono::nanoseconds(record.elapsed_ns);
+        const auto& t = record.telemetry;
+        const auto rate =
+            (duration.count() > 0)
+                ? static_cast<uint64_t>(static_cast<double>(t.keys_tried) /
+                                        duration.count())
+                : 0;
+
+        if (format == LogFormat::Json) {
+            std::string line = std::format(
+                R"({{"event":"best","elapsed_seconds":{:.3f},)"
+                R"("keys_tried":{},"keys_per_second":{},"zero_bits":{},)"
+                R"("ipv6_zero_blocks":{}{},"private_key":"{}",)"
+                R"("public_key":"{}","address":"{}")",
+                duration.count(), t.keys_tried, rate, c.zero_bits,
+                c.ipv6_zero_blocks, target, priv, pub, addr);
+            if (verbose) {
+                line += std::format(
+                    R"(,"seeds_ns":{},"generate_ns":{},"score_ns":{},)"
+                    R"("candidates_pushed":{},"threshold_rejects":{},)"
+                    R"("queue_overflows":{})",
+                    t.seeds_ns, t.generate_ns, t.score_ns,
+                    t.candidates_pushed, t.threshold_rejects,
+                    record.queue_overflows);
+            }
+            return line + "}";
+        }
+
+        std::string text;
+        if (static_cast<uint64_t>(duration.count()) > 0) {
+            text += std::format("----- {} --- {} keys tried\n",
+                                format_duration_go_style(duration),
+                                t.keys_tried);
+            if (verbose) {
+                text += std::format(
+                    "----- generation speed {} keys per second\n", rate);
+                text += FormatTelemetry(t);
+                if (record.queue_overflows != 0) {
+                    text += std::format("----- candidate queue overflows {}\n",
+                                        record.queue_overflows);
+                }
+            }
+        }
+        text += std::format("Priv: {}\nPub: {}\nIP: {}", priv, pub, addr);
+        return text;
+    }
+
+   private:
+    LogFormat format_;
+    bool verbose_;
+    std::vector<std::unique_ptr<Ring>> rings_;  ///< one per producer
+    std::vector<LogRecord> pending_;  ///< records of one flush, printer only
+    std::jthread thread_;             ///< the printer thread
+
+    /**
+     * @brief Writes every record currently in the rings.
+     *
+     * Rings are drained from the last one (the manager's, by convention)
+     * down, so a Result is never written before the NewBest record that
+     * led to it.
+     *
+     * @return true if anything was written
+     */
+    bool Flush()
+    {
+        for (size_t i = rings_.size(); i-- > 0;) {
+            while (auto record = rings_[i]->try_pop()) {
+                pending_.push_back(*record);
+            }
+        }
+        if (pending_.empty()) {
+            return false;
+        }
+
+        std::ranges::stable_sort(pending_, {}, &LogRecord::time);
+        std::string out;
+        for (const auto& record : pending_) {
+            out += Format(record, format_, verbose_);
+            out += '\n';
+        }
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        std::fflush(stdout);
+
+        sodium_memzero(out.data(), out.size());
+        sodium_memzero(pending_.data(), pending_.size() * sizeof(LogRecord));
+        pending_.clear();
+        return true;
+    }
+
+    static std::string FormatTelemetry(const TelemetrySnapshot& t)
+    {
+        std::string text;
+        const double total_ns =
+            static_cast<double>(t.seeds_ns + t.generate_ns + t.score_ns);
+        if (total_ns > 0) {
+            const auto percent = [total_ns](uint64_t ns) {
+                return 100.0 * static_cast<double>(ns) / total_ns;
+            };
+            text += std::format(
+                "----- time in seeds {:.1f}% | keys {:.1f}% | scoring "
+                "{:.1f}%\n",
+                percent(t.seeds_ns), percent(t.generate_ns),
+                percent(t.score_ns));
+        }
+        text += std::format("----- candidates pushed {} | below global best {}\n",
+                            t.candidates_pushed, t.threshold_rejects);
+        return text;
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
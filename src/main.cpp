@@ -1,15 +1,25 @@
+#include <chrono>
 #include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <optional>
 #include <print>
 #include <sstream>
 #include <thread>
+#include <utility>
 
 #include <clipp.h>  // clipp for command-line parsing
 
 #include "common.h"
+#include "ge25519_base_table.h"
+#include "key_engine.h"
 #include "version.h"  // Generated version header
 #include "worker_manager.h"
 
+using yggdrasil_cpp_genkeys::GeTableShape;
+using yggdrasil_cpp_genkeys::KeyEngineOptions;
 using yggdrasil_cpp_genkeys::Settings;
 using yggdrasil_cpp_genkeys::WorkerManager;
 
@@ -45,7 +55,7 @@ void signal_handler(int signal)
  * 
  * @param argc argument count
  * @param argv argument vector
- * @return exit code (0 on success, 1 on parsing error)
+ * @return exit code (0 on success, 1 on parsing or settings error)
  */
 int main(int argc, char* argv[])
 {
@@ -70,9 +80,49 @@ int main(int argc, char* argv[])
          clipp::option("-v", "--verbose")
              .set(settings.verbose)
              .doc("Enable verbose output with additional statistics"),
+         clipp::option("--format") &
+             clipp::value("FORMAT", settings.output_format)
+                 .doc("Output format: text, or json for one JSON object per "
+                      "line (default: text)"),
          clipp::option("--ipv6-nice")
              .set(settings.ipv6_nice)
              .doc("Search for zero blocks in IPv6 address"),
+         clipp::option("--pattern") &
+             clipp::value("PATTERN", settings.pattern)
+                 .doc("Search for an address matching a template such as "
+                      "200:dead:beef:* (hex digits, ? for any digit, * for "
+                      "any group or all remaining groups); stops at the "
+                      "first match unless a target is set"),
+         clipp::option("--pattern-file") &
+             clipp::value("FILE", settings.pattern_file)
+                 .doc("Search for all address templates of FILE, one per "
+                      "line, each keeping its own best match; stops when "
+                      "every template has one"),
+         clipp::option("--engine") &
+             clipp::value("NAME", settings.engine)
+                 .doc("Key engine: auto, libsodium, batch, batch-x2, "
+                      "batch-x4, batch-bmi2, batch-avx2 (default: auto - "
+                      "fastest in a startup calibration)"),
+         clipp::option("--unsafe-vartime")
+             .set(settings.unsafe_vartime)
+             .doc("Variable-time base table lookups (faster, leaks secret "
+                  "keys through timing; isolated hosts only)"),
+         clipp::option("--table-window") &
+             clipp::integer("BITS", settings.table_window)
+                 .doc("Base table digit width, 2..12 (default: 4)"),
+         clipp::option("--table-spacing") &
+             clipp::integer("N", settings.table_spacing)
+                 .doc("Digits sharing one base table row, 1..8 (default: 2)"),
+         clipp::option("--table-cache") &
+             clipp::value("DIR", settings.table_cache_dir)
+                 .doc("Directory of cached base tables (default: "
+                      "$XDG_CACHE_HOME/yggdrasil-cpp-genkeys)"),
+         clipp::option("--no-table-cache")
+             .set(settings.no_table_cache)
+             .doc("Compute base tables in memory on every start"),
+         clipp::option("--no-huge-pages")
+             .set(settings.no_huge_pages)
+             .doc("Keep computed base tables on regular 4 KiB pages"),
          clipp::option("-h", "--help").set(help).doc("Show this help message"));
 
     if (!clipp::parse(argc, argv, cli) || help) {
@@ -89,10 +139,137 @@ int main(int argc, char* argv[])
         settings.threads_count = std::thread::hardware_concurrency();
     }
 
-    std::println("Threads: {}", settings.threads_count);
+    const GeTableShape table_shape{.window = settings.table_window,
+                                   .spacing = settings.table_spacing};
+    if (not table_shape.IsValid()) {
+        std::println(stderr, "Invalid base table: window {}, spacing {}",
+                     table_shape.window, table_shape.spacing);
+        return 1;
+    }
+
+    const auto format =
+        yggdrasil_cpp_genkeys::ParseLogFormat(settings.output_format);
+    if (not format.has_value()) {
+        std::println(stderr, "Unknown output format: {}",
+                     settings.output_format);
+        return 1;
+    }
+    // keep stdout machine-readable in json mode
+    FILE* const info =
+        (*format == yggdrasil_cpp_genkeys::LogFormat::Json) ? stderr : stdout;
+
+    if (static_cast<int>(settings.ipv6_nice) +
+            static_cast<int>(not settings.pattern.empty()) +
+            static_cast<int>(not settings.pattern_file.empty()) >
+        1) {
+        std::println(stderr,
+                     "--ipv6-nice, --pattern and --pattern-file are exclusive");
+        return 1;
+    }
+    std::optional<yggdrasil_cpp_genkeys::AddressPattern> pattern;
+    if (not settings.pattern.empty()) {
+        pattern = yggdrasil_cpp_genkeys::AddressPattern::Parse(settings.pattern);
+        if (not pattern.has_value()) {
+            std::println(stderr, "Invalid address pattern: {}",
+                         settings.pattern);
+            return 1;
+        }
+    }
+
+    std::shared_ptr<const yggdrasil_cpp_genkeys::PatternSet> pattern_set;
+    if (not settings.pattern_file.empty()) {
+        std::ifstream file(settings.pattern_file);
+        if (not file) {
+            std::println(stderr, "Cannot open pattern file: {}",
+                         settings.pattern_file);
+            return 1;
+        }
+        size_t bad_line = 0;
+        auto patterns = yggdrasil_cpp_genkeys::ReadPatterns(file, bad_line);
+        if (not patterns.has_value()) {
+            std::println(stderr, "Invalid address pattern: {}:{}",
+                         settings.pattern_file, bad_line);
+            return 1;
+        }
+        if (patterns->empty()) {
+            std::println(stderr, "No address patterns in {}",
+                         settings.pattern_file);
+            return 1;
+        }
+        std::println(info, "Address patterns: {}", patterns->size());
+        pattern_set = std::make_shared<const yggdrasil_cpp_genkeys::PatternSet>(
+            std::move(*patterns));
+    }
+
+    if ((settings.engine != yggdrasil_cpp_genkeys::KEY_ENGINE_AUTO) and
+        (yggdrasil_cpp_genkeys::FindKeyEngine(settings.engine) == nullptr)) {
+        std::println(stderr, "Unknown key engine: {}", settings.engine);
+        return 1;
+    }
+
+    yggdrasil_cpp_genkeys::GeTableStorageOptions table_storage{
+        .cache_dir = {}, .huge_pages = not settings.no_huge_pages};
+    if (not settings.no_table_cache) {
+        table_storage.cache_dir =
+            settings.table_cache_dir.empty()
+                ? yggdrasil_cpp_genkeys::DefaultTableCacheDir()
+                : std::filesystem::path(settings.table_cache_dir);
+    }
+    yggdrasil_cpp_genkeys::SetBaseTableStorage(table_storage);
+
+    std::println(info, "Threads: {}", settings.threads_count);
+    // build or map the table once before the workers start sharing it
+    const auto& table = yggdrasil_cpp_genkeys::GetBaseTable(table_shape);
+    std::println(info, "Base table: window {}, spacing {}, {} KiB, {}",
+                 table_shape.window, table_shape.spacing,
+                 table_shape.Bytes() / 1024, table.Origin());
+    std::println(info, "Base table pages: {}", table.Pages());
+
+    const KeyEngineOptions engine_options{.unsafe_vartime =
+                                              settings.unsafe_vartime,
+                                          .table_shape = table_shape};
+    if (settings.engine == yggdrasil_cpp_genkeys::KEY_ENGINE_AUTO) {
+        constexpr auto CALIBRATION_TIME = std::chrono::milliseconds(100);
+        const auto rates = yggdrasil_cpp_genkeys::CalibrateKeyEngines(
+            engine_options, CALIBRATION_TIME,
+            yggdrasil_cpp_genkeys::Worker::BATCH_SIZE);
+        if (settings.verbose) {
+            for (const auto& rate : rates) {
+                std::println(info,
+                             "Key engine calibration: {:<12} {:>10.0f} keys/s",
+                             rate.name, rate.keys_per_second);
+            }
+        }
+        settings.engine = yggdrasil_cpp_genkeys::FastestKeyEngine(rates);
+    }
+    const auto* engine = yggdrasil_cpp_genkeys::FindKeyEngine(settings.engine);
+    if (not engine->available()) {
+        std::println(stderr, "Key engine {} is not supported by this CPU",
+                     settings.engine);
+        return 1;
+    }
+    std::println(info, "Key engine: {} ({})", engine->name,
+                 engine->description);
+    if (settings.verbose) {
+        std::println(info, "Kernel ISA level: {}",
+                     yggdrasil_cpp_genkeys::IsaLevelName(
+                         engine_options.isa_level));
+    }
+
+    if (settings.unsafe_vartime) {
+        std::println(stderr,
+                     "WARNING: --unsafe-vartime is enabled!\n"
+                     "WARNING: key derivation is NOT constant time, secret "
+                     "keys leak through\n"
+                     "WARNING: timing and cache side channels. Only use it "
+                     "on isolated hosts\n"
+                     "WARNING: that run nothing else and never share the "
+                     "CPU with untrusted code.");
+    }
 
     // Create and initialize the worker manager
-    g_manager = std::make_unique<WorkerManager>(settings);
+    g_manager =
+        std::make_unique<WorkerManager>(settings, pattern, pattern_set);
 
     // Run the main processing loop (blocks until completion or signal)
     g_manager->Run();
@@ -0,0 +1,133 @@
+/**
+ * @file mpsc_ring.h
+ * @brief Bounded lock-free queue for many producers and one consumer
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "cpu_features.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Fixed-capacity ring of @p CAPACITY elements, never allocates.
+ *
+ * Every slot carries a sequence number that tells whether it is free for
+ * the producer of a given position or filled for the consumer (D. Vyukov's
+ * bounded queue). Producers claim positions with a CAS on the head; the
+ * single consumer owns the tail outright. Neither side waits for the
+ * other: try_push() fails when the ring is full and try_pop() when it is
+ * empty.
+ *
+ * A full ring drops the element and counts it in Overflows(); producers
+ * that cannot afford to lose an element keep it and offer it again later.
+ *
+ * @tparam T trivially copyable element
+ * @tparam CAPACITY number of slots, a power of two
+ */
+template <typename T, size_t CAPACITY>
+class MpscRing
+{
+    static_assert((CAPACITY >= 2) and ((CAPACITY & (CAPACITY - 1)) == 0),
+                  "capacity must be a power of two");
+
+   public:
+    MpscRing()
+    {
+        for (size_t i = 0; i < CAPACITY; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+    MpscRing(MpscRing&&) = delete;
+    MpscRing& operator=(MpscRing&&) = delete;
+
+    /**
+     * @brief Appends @p value unless the ring is full.
+     *
+     * Safe to call from any number of threads.
+     *
+     * @return false if the ring was full and @p value was dropped
+     */
+    bool try_push(const T& value)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & MASK];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::ptrdiff_t>(sequence) -
+                static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Takes the oldest element, if any.
+     *
+     * Must only be called from the single consumer thread.
+     */
+    std::optional<T> try_pop()
+    {
+        Slot& slot = slots_[tail_ & MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return std::nullopt;
+        }
+        std::optional<T> value = slot.value;
+        slot.sequence.store(tail_ + CAPACITY, std::memory_order_release);
+        ++tail_;
+        return value;
+    }
+
+    /**
+     * @brief Number of elements dropped by try_push() so far.
+     */
+    [[nodiscard]] uint64_t Overflows() const
+    {
+        return overflows_.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t Capacity() { return CAPACITY; }
+
+   private:
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    /// One element with its sequence number, on a cache line of its own
+    /// when T fits, so neighbouring producers do not share lines.
+    struct alignas(CACHE_LINE_SIZE) Slot
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_ = 0;  ///< next push
+    alignas(CACHE_LINE_SIZE) size_t tail_ = 0;  ///< next pop, consumer only
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> overflows_ = 0;
+    std::array<Slot, CAPACITY> slots_;
+};
+
+}  // namespace yggdrasil_cpp_genkeys
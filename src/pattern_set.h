@@ -0,0 +1,229 @@
+/**
+ * @file pattern_set.h
+ * @brief Many address templates indexed for matching every key against all
+ * of them
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "address_pattern.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Reads one address template per line.
+ *
+ * Blank lines and lines starting with # are skipped; targets are numbered
+ * from 0 in the order of the remaining lines.
+ *
+ * @param[out] bad_line 1-based number of the first invalid line, 0 if none
+ * @return nullopt if a line is not a template
+ */
+inline std::optional<std::vector<AddressPattern>> ReadPatterns(
+    std::istream& in, size_t& bad_line)
+{
+    std::vector<AddressPattern> patterns;
+    std::string line;
+    bad_line = 0;
+    for (size_t number = 1; std::getline(in, line); ++number) {
+        std::string_view text = line;
+        const auto first = text.find_first_not_of(" \t\r");
+        if ((first == std::string_view::npos) or (text[first] == '#')) {
+            continue;
+        }
+        text = text.substr(first, text.find_last_not_of(" \t\r") + 1 - first);
+        const auto pattern = AddressPattern::Parse(text);
+        if (not pattern.has_value()) {
+            bad_line = number;
+            return std::nullopt;
+        }
+        patterns.push_back(*pattern);
+    }
+    return patterns;
+}
+
+/**
+ * @brief Address templates (targets) with an index over their prefixes.
+ *
+ * Targets that fix the first PREFIX_BITS address bits (the 0x02 prefix,
+ * the leading ones count and the second group, e.g. `200:dead:*`) are
+ * bucketed by that prefix in an open-addressing hash table; an address
+ * looks up its own prefix and only compares the targets of that bucket.
+ * In front of the table sits a Bloom-style filter of one 64-bit word per
+ * lookup with two bits per prefix, so most addresses are ruled out by a
+ * single load. Targets with wildcards in the prefix cannot be bucketed and
+ * are compared with every address; keep them few.
+ *
+ * Immutable once built and shared by all workers.
+ */
+class PatternSet
+{
+   public:
+    /// Address bits a target must fix to be indexed
+    static constexpr size_t PREFIX_BITS = 32;
+
+    /**
+     * @brief Indexes @p patterns, target i being patterns[i].
+     */
+    explicit PatternSet(std::vector<AddressPattern> patterns)
+        : patterns_(std::move(patterns))
+    {
+        std::vector<uint32_t> indexed;
+        for (uint32_t i = 0; i < patterns_.size(); ++i) {
+            if ((patterns_[i].mask[0] >> (64 - PREFIX_BITS)) == PREFIX_MASK) {
+                indexed.push_back(i);
+            }
+            else {
+                unindexed_.push_back(i);
+            }
+        }
+        std::ranges::sort(indexed, {},
+                          [this](uint32_t i) { return Prefix(patterns_[i]); });
+
+        size_t prefixes = 0;
+        for (size_t i = 0; i < indexed.size(); ++i) {
+            prefixes += static_cast<size_t>(
+                (i == 0) or (Prefix(patterns_[indexed[i]]) !=
+                             Prefix(patterns_[indexed[i - 1]])));
+        }
+        // load factor at most 1/2, 64 filter bits per 4 prefixes
+        buckets_.resize(std::bit_ceil(std::max<size_t>(2 * prefixes, 2)));
+        filter_.resize(std::bit_ceil(std::max<size_t>(prefixes / 4, 1)));
+
+        entries_.reserve(indexed.size());
+        for (size_t begin = 0; begin < indexed.size();) {
+            const uint32_t prefix = Prefix(patterns_[indexed[begin]]);
+            size_t end = begin;
+            while ((end < indexed.size()) and
+                   (Prefix(patterns_[indexed[end]]) == prefix)) {
+                entries_.push_back(indexed[end]);
+                ++end;
+            }
+            const uint64_t hash = Hash(prefix);
+            filter_[FilterWord(hash)] |= FilterBits(hash);
+            size_t slot = hash & (buckets_.size() - 1);
+            while (buckets_[slot].count != 0) {
+                slot = (slot + 1) & (buckets_.size() - 1);
+            }
+            buckets_[slot] = {.prefix = prefix,
+                              .begin = static_cast<uint32_t>(begin),
+                              .count = static_cast<uint32_t>(end - begin)};
+            begin = end;
+        }
+    }
+
+    [[nodiscard]] size_t Size() const { return patterns_.size(); }
+
+    [[nodiscard]] const AddressPattern& operator[](size_t target) const
+    {
+        return patterns_[target];
+    }
+
+    /**
+     * @brief Calls @p f with every target the address @p hi, @p lo
+     * (big-endian words) matches.
+     */
+    template <typename F>
+    void ForEachMatch(uint64_t hi, uint64_t lo, F&& f) const
+    {
+        for (const uint32_t target : Bucket(hi)) {
+            if (patterns_[target].Matches(hi, lo)) {
+                f(target);
+            }
+        }
+        for (const uint32_t target : unindexed_) {
+            if (patterns_[target].Matches(hi, lo)) {
+                f(target);
+            }
+        }
+    }
+
+    /**
+     * @brief Whether the address @p hi, @p lo matches any target.
+     */
+    [[nodiscard]] bool AnyMatch(uint64_t hi, uint64_t lo) const
+    {
+        const auto matches = [this, hi, lo](uint32_t target) {
+            return patterns_[target].Matches(hi, lo);
+        };
+        return std::ranges::any_of(Bucket(hi), matches) or
+               std::ranges::any_of(unindexed_, matches);
+    }
+
+   private:
+    static constexpr uint64_t PREFIX_MASK = (uint64_t{1} << PREFIX_BITS) - 1;
+
+    struct Slot
+    {
+        uint32_t prefix = 0;
+        uint32_t begin = 0;  ///< first target in entries_
+        uint32_t count = 0;  ///< 0 for a free slot
+    };
+
+    std::vector<AddressPattern> patterns_;  ///< by target number
+    std::vector<uint32_t> entries_;         ///< indexed targets by prefix
+    std::vector<uint32_t> unindexed_;       ///< targets compared always
+    std::vector<Slot> buckets_;             ///< prefix -> range of entries_
+    std::vector<uint64_t> filter_;          ///< Bloom-style prefix filter
+
+    static uint32_t Prefix(const AddressPattern& pattern)
+    {
+        return static_cast<uint32_t>(pattern.value[0] >> (64 - PREFIX_BITS));
+    }
+
+    /// splitmix64 finalizer, every bit of the prefix reaches every bit
+    static constexpr uint64_t Hash(uint32_t prefix)
+    {
+        uint64_t h = prefix;
+        h = (h ^ (h >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27U)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31U);
+    }
+
+    [[nodiscard]] size_t FilterWord(uint64_t hash) const
+    {
+        return (hash >> 16U) & (filter_.size() - 1);
+    }
+
+    static constexpr uint64_t FilterBits(uint64_t hash)
+    {
+        return (uint64_t{1} << (hash >> 58U)) |
+               (uint64_t{1} << ((hash >> 52U) & 63U));
+    }
+
+    /// Targets indexed under the prefix of @p hi, usually none
+    [[nodiscard]] std::span<const uint32_t> Bucket(uint64_t hi) const
+    {
+        const auto prefix = static_cast<uint32_t>(hi >> (64 - PREFIX_BITS));
+        const uint64_t hash = Hash(prefix);
+        const uint64_t bits = FilterBits(hash);
+        if ((filter_[FilterWord(hash)] & bits) != bits) {
+            return {};
+        }
+        for (size_t slot = hash & (buckets_.size() - 1);
+             buckets_[slot].count != 0;
+             slot = (slot + 1) & (buckets_.size() - 1)) {
+            if (buckets_[slot].prefix == prefix) {
+                return std::span(entries_).subspan(buckets_[slot].begin,
+                                                   buckets_[slot].count);
+            }
+        }
+        return {};
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
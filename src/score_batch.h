@@ -0,0 +1,299 @@
+/**
+ * @file score_batch.h
+ * @brief Threshold filters over blocks of public keys in SoA layout
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "ed25519_keys.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Keys filtered together, one bit each in a mask
+constexpr size_t SCORE_BLOCK = 16;
+
+/// Mask with a bit for every key of a block
+using ScoreMask = uint32_t;
+
+/**
+ * @brief The first 192 bits of SCORE_BLOCK public keys, word by word.
+ *
+ * Word k of key i is big-endian bytes 8k..8k+7 of the key, so leading zero
+ * bits are leading zeros of w0 and bit j of the key is bit 63 - j % 64 of
+ * word j / 64. 192 bits cover the 112 address bits after up to 63 leading
+ * zeros; keys with 64 or more leave the filters unresolved.
+ */
+struct KeyBlock
+{
+    alignas(32) std::array<uint64_t, SCORE_BLOCK> w0;
+    alignas(32) std::array<uint64_t, SCORE_BLOCK> w1;
+    alignas(32) std::array<uint64_t, SCORE_BLOCK> w2;
+};
+
+/**
+ * @brief Transposes the first @p WORDS words of the public keys of @p keys
+ * into @p block.
+ *
+ * @tparam WORDS 1 for the leading zeros filter, 3 for the address filter
+ */
+template <size_t WORDS = 3>
+inline void LoadKeyBlock(std::span<const Keys_t, SCORE_BLOCK> keys,
+                         KeyBlock& block)
+{
+    static_assert((WORDS >= 1) and (WORDS <= 3));
+
+    const auto word = [](const PublicKey_t& key, size_t k) {
+        return LoadBigEndian64(key.bytes.data() + (8 * k));
+    };
+    for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+        block.w0[i] = word(keys[i].public_key, 0);
+        if constexpr (WORDS > 1) {
+            block.w1[i] = word(keys[i].public_key, 1);
+        }
+        if constexpr (WORDS > 2) {
+            block.w2[i] = word(keys[i].public_key, 2);
+        }
+    }
+}
+
+namespace score_batch
+{
+
+/// Address groups after the prefix group, see AddressZeroBlocks()
+constexpr size_t ADDRESS_GROUPS = 7;
+
+/// w0 must be below this for more than @p zero_bits leading zero bits;
+/// 1 (only w0 == 0, unresolved) from 63 bits on.
+constexpr uint64_t ZeroBitsLimit(uint64_t zero_bits)
+{
+    return (zero_bits >= 63) ? 1 : (uint64_t{1} << (63 - zero_bits));
+}
+
+inline ScoreMask LeadingZerosMaskScalar(const KeyBlock& block, uint64_t rank)
+{
+    const uint64_t limit = ZeroBitsLimit(rank);
+    ScoreMask mask = 0;
+    for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+        mask |= static_cast<ScoreMask>(block.w0[i] < limit) << i;
+    }
+    return mask;
+}
+
+/**
+ * @brief Ipv6NiceScoring::Rank() of key @p i, or UINT64_MAX if the key has
+ * 64 or more leading zero bits.
+ *
+ * The address groups 1..7 are the 112 bits after the leading zeros and the
+ * first one bit of the key, inverted; a zero group is a run of 16 one bits
+ * in the key.
+ */
+inline uint64_t Ipv6NiceRank(const KeyBlock& block, size_t i)
+{
+    const uint64_t w0 = block.w0[i];
+    const uint64_t w1 = block.w1[i];
+    const uint64_t w2 = block.w2[i];
+    if (w0 == 0) {
+        return UINT64_MAX;
+    }
+    const auto zeros = static_cast<unsigned>(std::countl_zero(w0));
+    const unsigned shift = zeros + 1;
+    const uint64_t hi =
+        (shift == 64) ? w1 : (w0 << shift) | (w1 >> (64 - shift));
+    const uint64_t lo =
+        (shift == 64) ? w2 : (w1 << shift) | (w2 >> (64 - shift));
+
+    unsigned groups = 0;  // bit 6 - g set if group g + 1 is zero
+    for (unsigned g = 0; g < ADDRESS_GROUPS; ++g) {
+        const uint64_t word = (g < 4) ? hi : lo;
+        const unsigned offset = 48 - (16 * (g % 4));
+        const bool zero = ((word >> offset) & 0xffffU) == 0xffffU;
+        groups |= static_cast<unsigned>(zero) << (6 - g);
+    }
+    uint64_t run = 0;  // longest run of set bits
+    for (unsigned k = 0; k < ADDRESS_GROUPS; ++k) {
+        run += static_cast<uint64_t>(groups != 0);
+        groups &= groups >> 1U;
+    }
+    return (run << 32U) | zeros;
+}
+
+/**
+ * @brief The address of key @p i as two big-endian words, see AddrForKey();
+ * only for keys with fewer than 64 leading zero bits (w0 != 0).
+ */
+inline std::array<uint64_t, 2> KeyAddress(const KeyBlock& block, size_t i)
+{
+    const uint64_t w0 = ~block.w0[i];
+    const uint64_t w1 = ~block.w1[i];
+    const uint64_t w2 = ~block.w2[i];
+    const auto ones = static_cast<unsigned>(std::countl_one(w0));
+    const unsigned shift = ones + 1;
+    const uint64_t hi =
+        (shift == 64) ? w1 : (w0 << shift) | (w1 >> (64 - shift));
+    const uint64_t lo =
+        (shift == 64) ? w2 : (w1 << shift) | (w2 >> (64 - shift));
+    return {(uint64_t{0x02} << 56U) | (uint64_t{ones} << 48U) | (hi >> 16U),
+            (hi << 48U) | (lo >> 16U)};
+}
+
+inline ScoreMask Ipv6NiceMaskScalar(const KeyBlock& block, uint64_t rank)
+{
+    ScoreMask mask = 0;
+    for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+        mask |= static_cast<ScoreMask>(Ipv6NiceRank(block, i) > rank) << i;
+    }
+    return mask;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/// Lanes of a 256-bit vector of 64-bit words
+constexpr size_t LANES = 4;
+
+[[gnu::target("avx2")]] inline __m256i Load(
+    const std::array<uint64_t, SCORE_BLOCK>& words, size_t i)
+{
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(&words[i]));
+}
+
+/// Four mask bits from the all-ones / all-zeros lanes of @p lanes
+[[gnu::target("avx2")]] inline ScoreMask MoveMask(__m256i lanes)
+{
+    return static_cast<ScoreMask>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(lanes)));
+}
+
+[[gnu::target("avx2")]] inline ScoreMask LeadingZerosMaskAvx2(
+    const KeyBlock& block, uint64_t rank)
+{
+    // unsigned w0 < limit as a signed compare of both with the sign flipped
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i limit = _mm256_xor_si256(
+        _mm256_set1_epi64x(static_cast<int64_t>(ZeroBitsLimit(rank))), sign);
+    ScoreMask mask = 0;
+    for (size_t i = 0; i < SCORE_BLOCK; i += LANES) {
+        const __m256i w0 = _mm256_xor_si256(Load(block.w0, i), sign);
+        mask |= MoveMask(_mm256_cmpgt_epi64(limit, w0)) << i;
+    }
+    return mask;
+}
+
+/**
+ * @brief Same as Ipv6NiceMaskScalar(), four keys per vector.
+ *
+ * Variable per-lane shifts line up the address bits of each key; the zero
+ * groups are compared lane-wise and the longest run comes from seven
+ * rounds of m &= m >> 1. Only the leading zero counts are scalar, as AVX2
+ * has no 64-bit lzcnt.
+ */
+[[gnu::target("avx2")]] inline ScoreMask Ipv6NiceMaskAvx2(
+    const KeyBlock& block, uint64_t rank)
+{
+    alignas(32) std::array<uint64_t, SCORE_BLOCK> zeros;
+    ScoreMask unresolved = 0;
+    for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+        zeros[i] = static_cast<uint64_t>(std::countl_zero(block.w0[i]));
+        unresolved |= static_cast<ScoreMask>(block.w0[i] == 0) << i;
+    }
+
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i sixty_four = _mm256_set1_epi64x(64);
+    const __m256i group_mask = _mm256_set1_epi64x(0xffff);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i threshold = _mm256_set1_epi64x(static_cast<int64_t>(rank));
+
+    ScoreMask mask = 0;
+    for (size_t i = 0; i < SCORE_BLOCK; i += LANES) {
+        const __m256i w0 = Load(block.w0, i);
+        const __m256i w1 = Load(block.w1, i);
+        const __m256i w2 = Load(block.w2, i);
+        const __m256i lz = Load(zeros, i);
+
+        // shifts by 64 give zero, so shift == 64 needs no special case
+        const __m256i shift = _mm256_add_epi64(lz, one);
+        const __m256i back = _mm256_sub_epi64(sixty_four, shift);
+        const __m256i hi = _mm256_or_si256(_mm256_sllv_epi64(w0, shift),
+                                           _mm256_srlv_epi64(w1, back));
+        const __m256i lo = _mm256_or_si256(_mm256_sllv_epi64(w1, shift),
+                                           _mm256_srlv_epi64(w2, back));
+
+        __m256i groups = zero;
+        for (unsigned g = 0; g < ADDRESS_GROUPS; ++g) {
+            const __m256i word = (g < 4) ? hi : lo;
+            const auto offset = static_cast<int>(48 - (16 * (g % 4)));
+            const __m256i bits = _mm256_and_si256(
+                _mm256_srl_epi64(word, _mm_cvtsi32_si128(offset)), group_mask);
+            const __m256i is_zero = _mm256_cmpeq_epi64(bits, group_mask);
+            groups = _mm256_or_si256(
+                groups, _mm256_and_si256(
+                            is_zero, _mm256_set1_epi64x(int64_t{1} << (6 - g))));
+        }
+
+        __m256i run = zero;
+        for (unsigned k = 0; k < ADDRESS_GROUPS; ++k) {
+            // run += (groups != 0)
+            const __m256i empty = _mm256_cmpeq_epi64(groups, zero);
+            run = _mm256_add_epi64(run, _mm256_andnot_si256(empty, one));
+            groups = _mm256_and_si256(groups, _mm256_srli_epi64(groups, 1));
+        }
+
+        const __m256i lane_rank =
+            _mm256_or_si256(_mm256_slli_epi64(run, 32), lz);
+        mask |= MoveMask(_mm256_cmpgt_epi64(lane_rank, threshold)) << i;
+    }
+    return mask | unresolved;
+}
+
+#endif
+
+}  // namespace score_batch
+
+/**
+ * @brief Keys of @p block with more than @p rank leading zero bits.
+ *
+ * Keys with 64 or more leading zero bits are always included.
+ *
+ * @param simd use AVX2, only if the CPU supports it
+ */
+inline ScoreMask LeadingZerosMask(const KeyBlock& block, uint64_t rank,
+                                  [[maybe_unused]] bool simd)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (simd) {
+        return score_batch::LeadingZerosMaskAvx2(block, rank);
+    }
+#endif
+    return score_batch::LeadingZerosMaskScalar(block, rank);
+}
+
+/**
+ * @brief Keys of @p block whose --ipv6-nice rank exceeds @p rank.
+ *
+ * Keys with 64 or more leading zero bits are always included.
+ *
+ * @param simd use AVX2, only if the CPU supports it
+ */
+inline ScoreMask Ipv6NiceMask(const KeyBlock& block, uint64_t rank,
+                              [[maybe_unused]] bool simd)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (simd) {
+        return score_batch::Ipv6NiceMaskAvx2(block, rank);
+    }
+#endif
+    return score_batch::Ipv6NiceMaskScalar(block, rank);
+}
+
+}  // namespace yggdrasil_cpp_genkeys
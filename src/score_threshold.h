@@ -0,0 +1,56 @@
+/**
+ * @file score_threshold.h
+ * @brief Global best score shared by all workers
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Rank of the global best candidate, see Candidate::Rank().
+ *
+ * Written only by the manager when its best improves and read by every
+ * worker once per batch, so it sits alone on its cache line: the line stays
+ * shared in all cores and a read is an L1 hit until the next improvement.
+ */
+class alignas(CACHE_LINE_SIZE) ScoreThreshold
+{
+   public:
+    /**
+     * @brief Returns the current rank to beat.
+     *
+     * Relaxed: a stale value only lets a few more candidates through, which
+     * the manager rejects anyway.
+     */
+    [[nodiscard]] uint64_t Load() const
+    {
+        return rank_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Raises the threshold to @p rank, never lowers it.
+     */
+    void Raise(uint64_t rank)
+    {
+        uint64_t current = rank_.load(std::memory_order_relaxed);
+        while ((rank > current) and
+               not rank_.compare_exchange_weak(current, rank,
+                                               std::memory_order_relaxed)) {
+        }
+    }
+
+   private:
+    std::atomic<uint64_t> rank_ = 0;
+};
+
+static_assert(sizeof(ScoreThreshold) == CACHE_LINE_SIZE);
+
+}  // namespace yggdrasil_cpp_genkeys
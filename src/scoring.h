@@ -0,0 +1,223 @@
+/**
+ * @file scoring.h
+ * @brief Search criteria the worker loop is specialized for
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "address_pattern.h"
+#include "candidate.h"
+#include "compare.h"
+#include "ed25519_keys.h"
+#include "pattern_set.h"
+#include "score_batch.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * A scoring policy is a type with
+ * - `Candidate Score(const PublicKey_t&) const`: the score of a key,
+ *   without seed;
+ * - `static uint64_t Rank(const Candidate&)`: the score packed into an
+ *   integer, higher is better, ordered like Candidate::IsBetter() in the
+ *   policy's mode;
+ * - `ScoreMask Mask(const KeyBlock&, uint64_t rank, bool simd) const`:
+ *   the keys of a block that may rank above @p rank, a superset of those
+ *   that do, so only they need Score();
+ * - `KEY_WORDS`: the words of the KeyBlock Mask() reads;
+ * - `MULTI_TARGET`: false, or true for a policy that keeps a best per
+ *   target itself and offers the keys of Mask() through
+ *   `ForEachImproved(const PublicKey_t&, F)` instead of Score().
+ *
+ * Workers are instantiated per policy and hold a copy of it, so the
+ * scoring loop of each mode is compiled without the checks of the others.
+ * Score() and Mask() may be static.
+ */
+
+/// Most leading zero bits of the public key (the default)
+struct LeadingZerosScoring
+{
+    static Candidate Score(const PublicKey_t& key)
+    {
+        Candidate score;
+        score.zero_bits = LeadingZeroBits(key);
+        return score;
+    }
+
+    static constexpr size_t KEY_WORDS = 1;
+    static constexpr bool MULTI_TARGET = false;
+
+    static uint64_t Rank(const Candidate& score) { return score.Rank(false); }
+
+    static ScoreMask Mask(const KeyBlock& block, uint64_t rank, bool simd)
+    {
+        return LeadingZerosMask(block, rank, simd);
+    }
+};
+
+/// Longest run of zero blocks in the address, then leading zero bits
+/// (--ipv6-nice)
+struct Ipv6NiceScoring
+{
+    static Candidate Score(const PublicKey_t& key)
+    {
+        Candidate score;
+        score.zero_bits = LeadingZeroBits(key);
+        score.ipv6_zero_blocks = AddressZeroBlocks(AddrForKey(key));
+        return score;
+    }
+
+    static constexpr size_t KEY_WORDS = 3;
+    static constexpr bool MULTI_TARGET = false;
+
+    static uint64_t Rank(const Candidate& score) { return score.Rank(true); }
+
+    static ScoreMask Mask(const KeyBlock& block, uint64_t rank, bool simd)
+    {
+        return Ipv6NiceMask(block, rank, simd);
+    }
+};
+
+/// Addresses matching an AddressPattern, then most leading zero bits
+/// (--pattern); keys that do not match all rank 0.
+struct PatternScoring
+{
+    /// Rank bit of a match, above any leading zero count
+    static constexpr uint64_t MATCH = uint64_t{1} << 32U;
+
+    AddressPattern pattern;
+
+    [[nodiscard]] Candidate Score(const PublicKey_t& key) const
+    {
+        Candidate score;
+        score.zero_bits = LeadingZeroBits(key);
+        score.pattern_match = pattern.MatchesLeadingZeros(score.zero_bits) and
+                              pattern.Matches(AddrForKey(key));
+        return score;
+    }
+
+    static constexpr size_t KEY_WORDS = 3;
+    static constexpr bool MULTI_TARGET = false;
+
+    static uint64_t Rank(const Candidate& score)
+    {
+        return score.pattern_match ? (MATCH | score.zero_bits) : 0;
+    }
+
+    /**
+     * @brief Keys of @p block that match and rank above @p rank.
+     *
+     * Scalar: the leading zero count rules out most keys before the two
+     * address words are compared. Keys with 64 or more leading zero bits
+     * are always included.
+     */
+    [[nodiscard]] ScoreMask Mask(const KeyBlock& block, uint64_t rank,
+                                 bool /*simd*/) const
+    {
+        ScoreMask mask = 0;
+        for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+            if (block.w0[i] == 0) {
+                mask |= ScoreMask{1} << i;
+                continue;
+            }
+            const auto zeros = static_cast<uint>(std::countl_zero(block.w0[i]));
+            if ((MATCH | zeros) <= rank) {
+                continue;
+            }
+            if (not pattern.MatchesLeadingZeros(zeros)) {
+                continue;
+            }
+            const auto addr = score_batch::KeyAddress(block, i);
+            mask |= static_cast<ScoreMask>(pattern.Matches(addr[0], addr[1]))
+                    << i;
+        }
+        return mask;
+    }
+};
+
+/// Every template of a PatternSet, each with its own best match: most
+/// leading zero bits (--pattern-file)
+struct MultiPatternScoring
+{
+    static constexpr size_t KEY_WORDS = 3;
+    static constexpr bool MULTI_TARGET = true;
+
+    std::shared_ptr<const PatternSet> targets;  ///< shared by all workers
+    std::vector<uint64_t> ranks;  ///< best rank per target of one worker
+
+    explicit MultiPatternScoring(std::shared_ptr<const PatternSet> set)
+        : targets(std::move(set)), ranks(targets->Size(), 0)
+    {
+    }
+
+    /// Score of a key without target, for the initial key of a worker
+    static Candidate Score(const PublicKey_t& key)
+    {
+        Candidate score;
+        score.zero_bits = LeadingZeroBits(key);
+        return score;
+    }
+
+    /// Ranks matches of one target like PatternScoring
+    static uint64_t Rank(const Candidate& score)
+    {
+        return PatternScoring::Rank(score);
+    }
+
+    /**
+     * @brief Keys of @p block that match any target.
+     *
+     * Mostly one filter word load per key. Keys with 64 or more leading
+     * zero bits are always included.
+     */
+    [[nodiscard]] ScoreMask Mask(const KeyBlock& block, uint64_t /*rank*/,
+                                 bool /*simd*/) const
+    {
+        ScoreMask mask = 0;
+        for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+            if (block.w0[i] == 0) {
+                mask |= ScoreMask{1} << i;
+                continue;
+            }
+            const auto addr = score_batch::KeyAddress(block, i);
+            mask |= static_cast<ScoreMask>(targets->AnyMatch(addr[0], addr[1]))
+                    << i;
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Calls @p f with the score of @p key for every target whose best
+     * so far it beats, and records it as that target's best.
+     */
+    template <typename F>
+    void ForEachImproved(const PublicKey_t& key, F&& f)
+    {
+        const auto addr = AddrForKey(key);
+        const uint64_t hi = LoadBigEndian64(addr.bytes.data());
+        const uint64_t lo = LoadBigEndian64(addr.bytes.data() + 8);
+        const uint zero_bits = LeadingZeroBits(key);
+        targets->ForEachMatch(hi, lo, [&](uint32_t target) {
+            Candidate score;
+            score.zero_bits = zero_bits;
+            score.target = target;
+            score.pattern_match = true;
+            const uint64_t rank = Rank(score);
+            if (rank > ranks[target]) {
+                ranks[target] = rank;
+                f(score);
+            }
+        });
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
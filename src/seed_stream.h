@@ -0,0 +1,116 @@
+/**
+ * @file seed_stream.h
+ * @brief Per-thread stream of independent random seeds
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <sodium.h>  // libsodium ChaCha20 and system randomness
+#ifdef __cplusplus
+}
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "ed25519_keys.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Hands out seeds read from a ChaCha20 keystream.
+ *
+ * Every stream is keyed from randombytes_buf() on first use, so
+ * streams of different threads and runs are disjoint, and seeds are as
+ * unrelated to each other as the outputs of a CSPRNG: unlike consecutive
+ * integers, knowing one seed tells nothing about the others.
+ *
+ * Seeds are generated SEEDS_PER_REFILL at a time, which costs about one
+ * ChaCha20 block per two seeds; the buffer is refilled under a new nonce,
+ * so no keystream block is ever used twice.
+ */
+class SeedStream
+{
+   public:
+    /// Seeds generated per keystream call
+    static constexpr size_t SEEDS_PER_REFILL = 128;
+
+    SeedStream() = default;
+
+    SeedStream(const SeedStream&) = delete;
+    SeedStream& operator=(const SeedStream&) = delete;
+    SeedStream(SeedStream&&) = delete;
+    SeedStream& operator=(SeedStream&&) = delete;
+
+    /**
+     * @brief Destructor - securely cleans up the key and unused seeds
+     */
+    ~SeedStream()
+    {
+        sodium_memzero(key_.data(), key_.size());
+        sodium_memzero(buffer_.data(), buffer_.size());
+    }
+
+    /**
+     * @brief Returns the next seed of the stream.
+     */
+    Seed_t Next()
+    {
+        Seed_t seed;
+        Take(seed);
+        return seed;
+    }
+
+    /**
+     * @brief Stores the next batch.size() seeds in the key sets of a batch.
+     */
+    void Fill(std::span<Keys_t> batch)
+    {
+        for (auto& keys : batch) {
+            Take(keys.seed);
+        }
+    }
+
+   private:
+    std::array<uint8_t, crypto_stream_chacha20_KEYBYTES> key_{};
+    uint64_t nonce_ = 0;  ///< number of refills so far
+    std::array<uint8_t, SEEDS_PER_REFILL * Seed_t::Size> buffer_{};
+    size_t next_ = SEEDS_PER_REFILL;  ///< index of the next unused seed
+
+    void Take(Seed_t& seed)
+    {
+        if (next_ == SEEDS_PER_REFILL) {
+            Refill();
+        }
+        std::copy_n(buffer_.begin() + (next_ * Seed_t::Size), Seed_t::Size,
+                    seed.bytes.begin());
+        ++next_;
+    }
+
+    void Refill()
+    {
+        static_assert(crypto_stream_chacha20_NONCEBYTES == sizeof(nonce_));
+
+        if (nonce_ == 0) {
+            randombytes_buf(key_.data(), key_.size());
+        }
+        std::array<uint8_t, crypto_stream_chacha20_NONCEBYTES> nonce{};
+        for (size_t i = 0; i < nonce.size(); ++i) {
+            nonce[i] = static_cast<uint8_t>(nonce_ >> (8 * i));
+        }
+        ++nonce_;
+        crypto_stream_chacha20(buffer_.data(), buffer_.size(), nonce.data(),
+                               key_.data());
+        next_ = 0;
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
@@ -0,0 +1,186 @@
+/**
+ * @file sha512.h
+ * @brief Fixed-shape SHA-512 of 32-byte seeds and shared constants
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "ed25519_keys.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Round constants of SHA-512 (FIPS 180-4, 4.2.3)
+constexpr std::array<uint64_t, 80> SHA512_K = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+    0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+    0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+    0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+    0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+    0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+    0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+    0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+    0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+    0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+    0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+    0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+    0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+/// Initial hash value of SHA-512 (FIPS 180-4, 5.3.5)
+constexpr std::array<uint64_t, 8> SHA512_IV = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1, 0x510e527fade682d1, 0x9b05688c2b3e6c1f,
+    0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+/// Message words 4..15 of the single padded block of a 32-byte input:
+/// the 0x80 terminator, zero fill and the 256-bit length.
+constexpr uint64_t SHA512_SEED_PAD_WORD = 0x8000000000000000;
+constexpr uint64_t SHA512_SEED_LENGTH_WORD = 256;
+
+using Sha512Digest = std::array<uint8_t, 64>;
+
+namespace sha512
+{
+
+constexpr uint64_t Sigma0(uint64_t a)
+{
+    return std::rotr(a, 28) ^ std::rotr(a, 34) ^ std::rotr(a, 39);
+}
+
+constexpr uint64_t Sigma1(uint64_t e)
+{
+    return std::rotr(e, 14) ^ std::rotr(e, 18) ^ std::rotr(e, 41);
+}
+
+constexpr uint64_t SmallSigma0(uint64_t w)
+{
+    return std::rotr(w, 1) ^ std::rotr(w, 8) ^ (w >> 7);
+}
+
+constexpr uint64_t SmallSigma1(uint64_t w)
+{
+    return std::rotr(w, 19) ^ std::rotr(w, 61) ^ (w >> 6);
+}
+
+using State = std::array<uint64_t, 8>;
+
+/**
+ * @brief One SHA-512 round with the sum K[t] + W[t] already computed.
+ */
+constexpr void Round(State& s, uint64_t kw)
+{
+    auto& [a, b, c, d, e, f, g, h] = s;
+    const uint64_t ch = (e & f) ^ (~e & g);
+    const uint64_t maj = (a & b) ^ (c & (a ^ b));
+    const uint64_t t1 = h + Sigma1(e) + ch + kw;
+    const uint64_t t2 = Sigma0(a) + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+}
+
+/// K[t] + W[t] of rounds 4..15, where the message words are padding only
+constexpr std::array<uint64_t, 12> PAD_ROUNDS_KW = [] {
+    std::array<uint64_t, 12> kw{};
+    for (size_t t = 4; t < 16; ++t) {
+        kw[t - 4] = SHA512_K[t];
+    }
+    kw[0] += SHA512_SEED_PAD_WORD;
+    kw[11] += SHA512_SEED_LENGTH_WORD;
+    return kw;
+}();
+
+}  // namespace sha512
+
+/**
+ * @brief SHA-512 specialized for the fixed 32-byte seed input.
+ *
+ * A 32-byte message is exactly one block whose words 4..15 are constant
+ * padding, so their round constants are folded in at compile time and the
+ * schedule words 16..31 lose most of their terms.
+ *
+ * This is the scalar path used when the multi-buffer kernel is unavailable.
+ */
+class Sha512SeedHasher
+{
+   public:
+    static void Hash(const Seed_t& seed, Sha512Digest& digest)
+    {
+        using namespace sha512;
+
+        std::array<uint64_t, 4> w{};
+        for (size_t i = 0; i < w.size(); ++i) {
+            for (size_t j = 0; j < 8; ++j) {
+                w[i] = (w[i] << 8) | seed.bytes[(i * 8) + j];
+            }
+        }
+
+        State s = SHA512_IV;
+        for (size_t t = 0; t < w.size(); ++t) {
+            Round(s, SHA512_K[t] + w[t]);
+        }
+        for (const uint64_t kw : PAD_ROUNDS_KW) {
+            Round(s, kw);
+        }
+
+        // message schedule with the zero padding words folded out
+        constexpr uint64_t PAD = SHA512_SEED_PAD_WORD;
+        constexpr uint64_t LEN = SHA512_SEED_LENGTH_WORD;
+        std::array<uint64_t, SHA512_K.size()> x{};
+        // W16 = s1(W14) + W9 + s0(W1) + W0, W17 = s1(W15) + W10 + s0(W2) + W1
+        x[16] = SmallSigma0(w[1]) + w[0];
+        x[17] = SmallSigma1(LEN) + SmallSigma0(w[2]) + w[1];
+        x[18] = SmallSigma1(x[16]) + SmallSigma0(w[3]) + w[2];
+        x[19] = SmallSigma1(x[17]) + SmallSigma0(PAD) + w[3];
+        x[20] = SmallSigma1(x[18]) + PAD;
+        x[21] = SmallSigma1(x[19]);
+        x[22] = SmallSigma1(x[20]) + LEN;
+        for (size_t t = 23; t < 30; ++t) {
+            x[t] = SmallSigma1(x[t - 2]) + x[t - 7];
+        }
+        x[30] = SmallSigma1(x[28]) + x[23] + SmallSigma0(LEN);
+        x[31] = SmallSigma1(x[29]) + x[24] + SmallSigma0(x[16]) + LEN;
+        for (size_t t = 32; t < x.size(); ++t) {
+            x[t] = SmallSigma1(x[t - 2]) + x[t - 7] + SmallSigma0(x[t - 15]) +
+                   x[t - 16];
+        }
+
+        for (size_t t = 16; t < x.size(); ++t) {
+            Round(s, SHA512_K[t] + x[t]);
+        }
+
+        for (size_t i = 0; i < s.size(); ++i) {
+            const uint64_t word = s[i] + SHA512_IV[i];
+            for (size_t j = 0; j < 8; ++j) {
+                digest[(i * 8) + j] =
+                    static_cast<uint8_t>(word >> (56 - (8 * j)));
+            }
+        }
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
@@ -0,0 +1,163 @@
+/**
+ * @file sha512_x4.h
+ * @brief Multi-buffer AVX2 SHA-512 of four 32-byte seeds at once
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "ed25519_keys.h"
+#include "sha512.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Number of seeds hashed by one call of Sha512SeedsX4()
+constexpr size_t SHA512_X4_LANES = 4;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace sha512_x4
+{
+
+[[gnu::target("avx2")]] static inline __m256i Rotr(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi64(x, n),
+                           _mm256_slli_epi64(x, 64 - n));
+}
+
+[[gnu::target("avx2")]] static inline __m256i Add(__m256i a, __m256i b)
+{
+    return _mm256_add_epi64(a, b);
+}
+
+[[gnu::target("avx2")]] static inline __m256i Xor3(__m256i a, __m256i b,
+                                                   __m256i c)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+[[gnu::target("avx2")]] static inline __m256i Sigma0(__m256i a)
+{
+    return Xor3(Rotr(a, 28), Rotr(a, 34), Rotr(a, 39));
+}
+
+[[gnu::target("avx2")]] static inline __m256i Sigma1(__m256i e)
+{
+    return Xor3(Rotr(e, 14), Rotr(e, 18), Rotr(e, 41));
+}
+
+[[gnu::target("avx2")]] static inline __m256i SmallSigma0(__m256i w)
+{
+    return Xor3(Rotr(w, 1), Rotr(w, 8), _mm256_srli_epi64(w, 7));
+}
+
+[[gnu::target("avx2")]] static inline __m256i SmallSigma1(__m256i w)
+{
+    return Xor3(Rotr(w, 19), Rotr(w, 61), _mm256_srli_epi64(w, 6));
+}
+
+/**
+ * @brief Loads big-endian message word @p word of every lane's seed.
+ */
+[[gnu::target("avx2")]] static inline __m256i LoadWord(
+    const std::array<const Seed_t*, SHA512_X4_LANES>& seeds, size_t word)
+{
+    std::array<uint64_t, SHA512_X4_LANES> lanes{};
+    for (size_t lane = 0; lane < SHA512_X4_LANES; ++lane) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value = (value << 8) | seeds[lane]->bytes[(word * 8) + i];
+        }
+        lanes[lane] = value;
+    }
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.data()));
+}
+
+}  // namespace sha512_x4
+
+/**
+ * @brief Hashes four 32-byte seeds with SHA-512 in parallel AVX2 lanes.
+ *
+ * Every seed fits into a single padded 1024-bit block whose words 4..15 are
+ * constant, so one compression per lane is all that is needed. Each 64-bit
+ * lane of the 256-bit registers carries the state of one message.
+ *
+ * @note The caller must check GetCpuFeatures().avx2 first.
+ */
+[[gnu::target("avx2")]] static inline void Sha512SeedsX4(
+    const std::array<const Seed_t*, SHA512_X4_LANES>& seeds,
+    std::array<Sha512Digest*, SHA512_X4_LANES>& digests)
+{
+    using namespace sha512_x4;
+
+    __m256i w[16];  // NOLINT(*-avoid-c-arrays)
+    for (size_t i = 0; i < 4; ++i) {
+        w[i] = LoadWord(seeds, i);
+    }
+    w[4] = _mm256_set1_epi64x(static_cast<int64_t>(SHA512_SEED_PAD_WORD));
+    for (size_t i = 5; i < 15; ++i) {
+        w[i] = _mm256_setzero_si256();
+    }
+    w[15] = _mm256_set1_epi64x(static_cast<int64_t>(SHA512_SEED_LENGTH_WORD));
+
+    __m256i state[8];  // NOLINT(*-avoid-c-arrays)
+    for (size_t i = 0; i < 8; ++i) {
+        state[i] = _mm256_set1_epi64x(static_cast<int64_t>(SHA512_IV[i]));
+    }
+    auto [a, b, c, d, e, f, g, h] = state;
+
+    for (size_t t = 0; t < SHA512_K.size(); ++t) {
+        // message schedule kept as a rolling window of 16 words
+        if (t >= 16) {
+            w[t % 16] = Add(Add(SmallSigma1(w[(t - 2) % 16]), w[(t - 7) % 16]),
+                            Add(SmallSigma0(w[(t - 15) % 16]), w[t % 16]));
+        }
+
+        const __m256i ch =
+            _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i maj = _mm256_xor_si256(
+            _mm256_and_si256(a, b),
+            _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        const __m256i t1 = Add(
+            Add(Add(h, Sigma1(e)), Add(ch, w[t % 16])),
+            _mm256_set1_epi64x(static_cast<int64_t>(SHA512_K[t])));
+        const __m256i t2 = Add(Sigma0(a), maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = Add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = Add(t1, t2);
+    }
+
+    const __m256i result[8] = {  // NOLINT(*-avoid-c-arrays)
+        Add(a, state[0]), Add(b, state[1]), Add(c, state[2]), Add(d, state[3]),
+        Add(e, state[4]), Add(f, state[5]), Add(g, state[6]), Add(h, state[7])};
+
+    std::array<uint64_t, SHA512_X4_LANES> lanes{};
+    for (size_t i = 0; i < 8; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.data()),
+                            result[i]);
+        for (size_t lane = 0; lane < SHA512_X4_LANES; ++lane) {
+            for (size_t j = 0; j < 8; ++j) {
+                (*digests[lane])[(i * 8) + j] =
+                    static_cast<uint8_t>(lanes[lane] >> (56 - (8 * j)));
+            }
+        }
+    }
+}
+
+#endif
+
+}  // namespace yggdrasil_cpp_genkeys
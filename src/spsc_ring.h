@@ -0,0 +1,116 @@
+/**
+ * @file spsc_ring.h
+ * @brief Bounded wait-free queue for one producer and one consumer
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+#include "cpu_features.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Fixed-capacity ring of @p CAPACITY elements, never allocates.
+ *
+ * The producer owns the head and the consumer the tail, each on its own
+ * cache line; both sides only read the other's index, so neither a push
+ * nor a pop ever waits or retries. A full ring drops the element and
+ * counts it in Drops(); push() waits for room instead, for the rare
+ * elements that must not be lost.
+ *
+ * @tparam T trivially copyable element
+ * @tparam CAPACITY number of slots, a power of two
+ */
+template <typename T, size_t CAPACITY>
+class SpscRing
+{
+    static_assert((CAPACITY >= 2) and ((CAPACITY & (CAPACITY - 1)) == 0),
+                  "capacity must be a power of two");
+
+   public:
+    SpscRing() = default;
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    SpscRing(SpscRing&&) = delete;
+    SpscRing& operator=(SpscRing&&) = delete;
+
+    /**
+     * @brief Appends @p value unless the ring is full; producer only.
+     *
+     * @return false if the ring was full and @p value was dropped
+     */
+    bool try_push(const T& value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == CAPACITY) {
+            drops_.store(drops_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+            return false;
+        }
+        slots_[head & MASK] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Appends @p value, yielding while the ring is full; producer
+     * only.
+     *
+     * Never drops, so the consumer must keep popping.
+     */
+    void push(const T& value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        while (head - tail_.load(std::memory_order_acquire) == CAPACITY) {
+            std::this_thread::yield();
+        }
+        slots_[head & MASK] = value;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Takes the oldest element, if any; consumer only.
+     *
+     * The slot is overwritten with a default T after the copy, so values
+     * do not linger in the ring.
+     */
+    std::optional<T> try_pop()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return std::nullopt;
+        }
+        std::optional<T> value = slots_[tail & MASK];
+        slots_[tail & MASK] = T{};
+        tail_.store(tail + 1, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * @brief Number of elements dropped by try_push() so far.
+     */
+    [[nodiscard]] uint64_t Drops() const
+    {
+        return drops_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_ = 0;  ///< next push
+    std::atomic<uint64_t> drops_ = 0;  ///< written by the producer only
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_ = 0;  ///< next pop
+    alignas(CACHE_LINE_SIZE) std::array<T, CAPACITY> slots_{};
+};
+
+}  // namespace yggdrasil_cpp_genkeys
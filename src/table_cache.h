@@ -0,0 +1,193 @@
+/**
+ * @file table_cache.h
+ * @brief Versioned, checksummed on-disk cache of precomputed tables
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <sodium.h>  // libsodium for the BLAKE2b checksum
+#ifdef __cplusplus
+}
+#endif
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "table_storage.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Bumped whenever the file layout changes, older files are rebuilt
+constexpr uint32_t TABLE_CACHE_VERSION = 1;
+constexpr std::array<char, 8> TABLE_CACHE_MAGIC = {'Y', 'G', 'G', 'T',
+                                                   'A', 'B', 'L', 'E'};
+/// Written in native byte order, a mismatch means a foreign file
+constexpr uint32_t TABLE_CACHE_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief Fixed-size header in front of the raw table payload.
+ *
+ * The payload starts right after the header, so a read-only mapping of the
+ * file can be used as the table in place.
+ */
+struct TableCacheHeader
+{
+    std::array<char, 8> magic{};
+    uint32_t version = 0;
+    uint32_t byte_order = 0;
+    std::array<char, 48> layout{};  ///< what the payload holds, see below
+    uint64_t payload_size = 0;
+    std::array<uint8_t, crypto_generichash_BYTES> checksum{};  ///< BLAKE2b
+    std::array<uint8_t, 24> reserved{};
+};
+static_assert(sizeof(TableCacheHeader) == 128);
+
+namespace table_cache
+{
+
+/**
+ * @brief Header expected for @p layout and @p payload.
+ *
+ * @p layout names the table type, its parameters and the in-memory format of
+ * its entries, e.g. "ge25519 comb w=4 s=2 r51". Files are only reused when
+ * it matches exactly.
+ */
+inline TableCacheHeader MakeHeader(std::string_view layout,
+                                   std::span<const std::byte> payload)
+{
+    TableCacheHeader header;
+    header.magic = TABLE_CACHE_MAGIC;
+    header.version = TABLE_CACHE_VERSION;
+    header.byte_order = TABLE_CACHE_BYTE_ORDER;
+    std::copy_n(layout.begin(), std::min(layout.size(), header.layout.size()),
+                header.layout.begin());
+    header.payload_size = payload.size();
+    crypto_generichash(header.checksum.data(), header.checksum.size(),
+                       reinterpret_cast<const unsigned char*>(payload.data()),
+                       payload.size(), nullptr, 0);
+    return header;
+}
+
+}  // namespace table_cache
+
+/**
+ * @brief Maps a cached table file and validates it.
+ *
+ * The file is rejected unless magic, version, byte order, layout and
+ * payload size match and the payload checksum is correct.
+ *
+ * @param path cache file
+ * @param layout expected layout description
+ * @param payload_size expected payload size in bytes
+ * @return read-only mapping of the whole file (the payload starts at
+ * sizeof(TableCacheHeader)) or std::nullopt
+ */
+inline std::optional<TableStorage> LoadTableCache(
+    const std::filesystem::path& path, std::string_view layout,
+    size_t payload_size)
+{
+    auto storage = TableStorage::MapFile(path.string());
+    if (not storage.has_value()) {
+        return std::nullopt;
+    }
+
+    const auto bytes = storage->Bytes();
+    if (bytes.size() != sizeof(TableCacheHeader) + payload_size) {
+        return std::nullopt;
+    }
+    TableCacheHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    const auto payload = bytes.subspan(sizeof(TableCacheHeader));
+    const auto expected = table_cache::MakeHeader(layout, payload);
+    if ((header.magic != expected.magic) or
+        (header.version != expected.version) or
+        (header.byte_order != expected.byte_order) or
+        (header.layout != expected.layout) or
+        (header.payload_size != expected.payload_size) or
+        (sodium_memcmp(header.checksum.data(), expected.checksum.data(),
+                       header.checksum.size()) != 0)) {
+        return std::nullopt;
+    }
+    return storage;
+}
+
+/**
+ * @brief Writes a table to the cache.
+ *
+ * The file is written under a temporary name and renamed into place, so
+ * concurrently starting instances never see a partial file.
+ *
+ * @return false if the file could not be written
+ */
+inline bool SaveTableCache(const std::filesystem::path& path,
+                           std::string_view layout,
+                           std::span<const std::byte> payload)
+{
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error) {
+        return false;
+    }
+
+    const auto header = table_cache::MakeHeader(layout, payload);
+    auto temp_path = path;
+    temp_path += ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(payload.data()),
+                   static_cast<std::streamsize>(payload.size()));
+        if (not file.flush()) {
+            file.close();
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Per-user cache directory, $XDG_CACHE_HOME or ~/.cache.
+ *
+ * @return empty path if neither variable is set
+ */
+inline std::filesystem::path DefaultTableCacheDir()
+{
+    constexpr std::string_view APP_DIR = "yggdrasil-cpp-genkeys";
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME");
+        (xdg != nullptr) and (*xdg != '\0')) {
+        return std::filesystem::path(xdg) / APP_DIR;
+    }
+    if (const char* home = std::getenv("HOME");
+        (home != nullptr) and (*home != '\0')) {
+        return std::filesystem::path(home) / ".cache" / APP_DIR;
+    }
+    return {};
+}
+
+}  // namespace yggdrasil_cpp_genkeys
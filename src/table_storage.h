@@ -0,0 +1,260 @@
+/**
+ * @file table_storage.h
+ * @brief Page-backed memory for large read-only precomputed tables
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/// Size of an x86-64 huge page
+constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+/**
+ * @brief Owner of a memory mapping holding a precomputed table.
+ *
+ * Either anonymous memory the table is built into, or a read-only shared
+ * mapping of a table cache file, so that the page cache shares it between
+ * all threads and all running instances.
+ *
+ * Every key walks the whole table, so large tables spread over many 4 KiB
+ * pages cost TLB misses. Built tables are therefore placed on 2 MiB pages
+ * when possible and file mappings get the transparent huge page hint.
+ */
+class TableStorage
+{
+   public:
+    TableStorage() = default;
+    TableStorage(const TableStorage&) = delete;
+    TableStorage& operator=(const TableStorage&) = delete;
+
+    TableStorage(TableStorage&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          mapped_size_(std::exchange(other.mapped_size_, 0)),
+          writable_(other.writable_)
+    {
+    }
+
+    TableStorage& operator=(TableStorage&& other) noexcept
+    {
+        if (this != &other) {
+            Release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapped_size_ = std::exchange(other.mapped_size_, 0);
+            writable_ = other.writable_;
+        }
+        return *this;
+    }
+
+    ~TableStorage() { Release(); }
+
+    /**
+     * @brief Allocates zeroed, writable anonymous memory.
+     *
+     * With @p huge_pages the memory comes from the hugetlb pool
+     * (MAP_HUGETLB) if it has free pages, otherwise it is aligned to 2 MiB
+     * and marked for transparent huge pages (MADV_HUGEPAGE). Either way the
+     * size is rounded up to whole huge pages. Plain pages are the last
+     * resort. DescribePages() tells which one the kernel actually used.
+     *
+     * @throw std::bad_alloc if the mapping fails, like any other allocation
+     */
+    static TableStorage Allocate(size_t size, bool huge_pages = true)
+    {
+        constexpr int PROT = PROT_READ | PROT_WRITE;
+        constexpr int FLAGS = MAP_PRIVATE | MAP_ANONYMOUS;
+        const size_t huge_size =
+            (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+        if (huge_pages) {
+#ifdef MAP_HUGETLB
+            void* data =
+                mmap(nullptr, huge_size, PROT, FLAGS | MAP_HUGETLB, -1, 0);
+            if (data != MAP_FAILED) {
+                return {data, size, huge_size, true};
+            }
+#endif
+#ifdef MADV_HUGEPAGE
+            // over-allocate by one huge page and trim to a 2 MiB boundary
+            void* raw =
+                mmap(nullptr, huge_size + HUGE_PAGE_SIZE, PROT, FLAGS, -1, 0);
+            if (raw != MAP_FAILED) {
+                auto* bytes = static_cast<std::byte*>(raw);
+                const auto address = reinterpret_cast<uintptr_t>(raw);
+                const size_t head =
+                    (HUGE_PAGE_SIZE - (address % HUGE_PAGE_SIZE)) %
+                    HUGE_PAGE_SIZE;
+                if (head > 0) {
+                    munmap(bytes, head);
+                }
+                munmap(bytes + head + huge_size, HUGE_PAGE_SIZE - head);
+                madvise(bytes + head, huge_size, MADV_HUGEPAGE);
+                return {bytes + head, size, huge_size, true};
+            }
+#endif
+        }
+
+        void* data = mmap(nullptr, size, PROT, FLAGS, -1, 0);
+        if (data == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return {data, size, size, true};
+    }
+
+    /**
+     * @brief Maps a whole file read-only and shared.
+     *
+     * @return std::nullopt if the file is missing, empty or cannot be mapped
+     */
+    static std::optional<TableStorage> MapFile(const std::string& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+
+        struct stat st{};
+        void* data = MAP_FAILED;
+        if ((fstat(fd, &st) == 0) and (st.st_size > 0)) {
+            data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                        MAP_SHARED, fd, 0);
+        }
+        close(fd);  // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED) {
+            return std::nullopt;
+        }
+        const auto size = static_cast<size_t>(st.st_size);
+#ifdef MADV_HUGEPAGE
+        // honoured by tmpfs mounted with huge= and file THP capable kernels
+        madvise(data, size, MADV_HUGEPAGE);
+#endif
+        return TableStorage(data, size, size, false);
+    }
+
+    [[nodiscard]] std::span<const std::byte> Bytes() const
+    {
+        return {static_cast<const std::byte*>(data_), size_};
+    }
+
+    /**
+     * @brief Writable view, empty for file mappings and after Seal().
+     */
+    [[nodiscard]] std::span<std::byte> Writable()
+    {
+        if (not writable_) {
+            return {};
+        }
+        return {static_cast<std::byte*>(data_), size_};
+    }
+
+    /**
+     * @brief Makes built memory read-only once the table is complete.
+     */
+    void Seal()
+    {
+        if (writable_ and (data_ != nullptr)) {
+            mprotect(data_, mapped_size_, PROT_READ);
+            writable_ = false;
+        }
+    }
+
+    /**
+     * @brief Page size the kernel actually backs the mapping with.
+     *
+     * Read from /proc/self/smaps, so it reflects the pages touched so far;
+     * call it once the table is filled in or verified.
+     */
+    [[nodiscard]] std::string DescribePages() const
+    {
+        std::ifstream smaps("/proc/self/smaps");
+        const auto address = reinterpret_cast<uintptr_t>(data_);
+        bool inside = false;
+        size_t huge_kib = 0;
+        std::string line;
+        while (std::getline(smaps, line)) {
+            uintptr_t begin = 0;
+            uintptr_t end = 0;
+            char dash = 0;
+            std::istringstream range(line);
+            if ((range >> std::hex >> begin >> dash >> end) and (dash == '-')) {
+                if (inside) {
+                    break;  // past our mapping
+                }
+                inside = (begin <= address) and (address < end);
+                continue;
+            }
+            if (not inside) {
+                continue;
+            }
+
+            std::istringstream field(line);
+            std::string name;
+            size_t kib = 0;
+            field >> name >> kib;
+            if ((name == "KernelPageSize:") and
+                (kib * 1024 == HUGE_PAGE_SIZE)) {
+                return "2 MiB hugetlb pages";
+            }
+            if ((name == "AnonHugePages:") or (name == "FilePmdMapped:")) {
+                huge_kib += kib;
+            }
+        }
+
+        if (not inside) {
+            return "unknown pages";
+        }
+        if (huge_kib > 0) {
+            return std::format("transparent huge pages ({} of {} KiB)",
+                               std::min(huge_kib, mapped_size_ / 1024),
+                               mapped_size_ / 1024);
+        }
+        return "4 KiB pages";
+    }
+
+   private:
+    void* data_ = nullptr;
+    size_t size_ = 0;         ///< usable bytes
+    size_t mapped_size_ = 0;  ///< bytes mapped, rounded up to whole pages
+    bool writable_ = false;
+
+    TableStorage(void* data, size_t size, size_t mapped_size, bool writable)
+        : data_(data),
+          size_(size),
+          mapped_size_(mapped_size),
+          writable_(writable)
+    {
+    }
+
+    void Release() noexcept
+    {
+        if (data_ != nullptr) {
+            munmap(data_, mapped_size_);
+            data_ = nullptr;
+            size_ = 0;
+            mapped_size_ = 0;
+        }
+    }
+};
+
+}  // namespace yggdrasil_cpp_genkeys
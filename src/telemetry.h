@@ -0,0 +1,105 @@
+/**
+ * @file telemetry.h
+ * @brief Per-worker counters read live by the manager
+ * @author oldnick85
+ * @date 2025
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+namespace yggdrasil_cpp_genkeys
+{
+
+/**
+ * @brief Plain copy of the counters of one or more workers.
+ */
+struct TelemetrySnapshot
+{
+    uint64_t keys_tried = 0;         ///< keys derived and scored
+    uint64_t candidates_pushed = 0;  ///< new bests queued for the manager
+    uint64_t threshold_rejects = 0;  ///< local bests below the global one
+    uint64_t seeds_ns = 0;           ///< time spent drawing seeds
+    uint64_t generate_ns = 0;        ///< time spent deriving keys
+    uint64_t score_ns = 0;           ///< time spent scoring keys
+
+    TelemetrySnapshot& operator+=(const TelemetrySnapshot& other)
+    {
+        keys_tried += other.keys_tried;
+        candidates_pushed += other.candidates_pushed;
+        threshold_rejects += other.threshold_rejects;
+        seeds_ns += other.seeds_ns;
+        generate_ns += other.generate_ns;
+        score_ns += other.score_ns;
+        return *this;
+    }
+};
+
+/**
+ * @brief Counters of one worker, written by its thread alone.
+ *
+ * With a single writer an update is a relaxed load and store rather than a
+ * locked read-modify-write, and readers only ever see whole values. The
+ * block fills its own cache line, so neither the worker's other state nor
+ * a neighbouring worker's counters share it.
+ */
+struct alignas(CACHE_LINE_SIZE) WorkerTelemetry
+{
+    using Counter = std::atomic<uint64_t>;
+
+    Counter keys_tried = 0;
+    Counter candidates_pushed = 0;
+    Counter threshold_rejects = 0;
+    Counter seeds_ns = 0;
+    Counter generate_ns = 0;
+    Counter score_ns = 0;
+
+    /**
+     * @brief Adds @p value to @p counter; owning thread only.
+     */
+    static void Add(Counter& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds the time elapsed since @p start to @p counter and returns
+     * the current time; owning thread only.
+     */
+    static std::chrono::steady_clock::time_point AddSince(
+        Counter& counter, std::chrono::steady_clock::time_point start)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        Add(counter, static_cast<uint64_t>(
+                         std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             now - start)
+                             .count()));
+        return now;
+    }
+
+    /**
+     * @brief Reads all counters, from any thread.
+     */
+    [[nodiscard]] TelemetrySnapshot Read() const
+    {
+        return {
+            .keys_tried = keys_tried.load(std::memory_order_relaxed),
+            .candidates_pushed =
+                candidates_pushed.load(std::memory_order_relaxed),
+            .threshold_rejects =
+                threshold_rejects.load(std::memory_order_relaxed),
+            .seeds_ns = seeds_ns.load(std::memory_order_relaxed),
+            .generate_ns = generate_ns.load(std::memory_order_relaxed),
+            .score_ns = score_ns.load(std::memory_order_relaxed),
+        };
+    }
+};
+
+static_assert(sizeof(WorkerTelemetry) == CACHE_LINE_SIZE);
+
+}  // namespace yggdrasil_cpp_genkeys
@@ -1,125 +1,308 @@
 #pragma once
 
-#include <iostream>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cassert>
+#include <memory>
+#include <semaphore>
+#include <span>
 #include <thread>
 
 #include "candidate.h"
+#include "common.h"
 #include "compare.h"
-#include "ed25519_keys_generator.h"
+#include "isa_dispatch.h"
+#include "key_engine.h"
+#include "log_printer.h"
+#include "mpsc_ring.h"
+#include "score_threshold.h"
+#include "scoring.h"
+#include "seed_stream.h"
+#include "telemetry.h"
 
 namespace yggdrasil_cpp_genkeys
 {
 
+/// Queue of new local bests from all workers to the manager
+using CandidateRing = MpscRing<Candidate, 256>;
+
+/// Wakes the manager up, released once per event
+using Wakeup = std::counting_semaphore<>;
+
 /**
  * @brief Worker class for generating and evaluating Ed25519 cryptographic keys.
  * 
  * This class runs in a separate thread and continuously generates key pairs,
  * comparing them against local and global best candidates. It supports
  * thread-safe synchronization of best keys between workers.
+ * 
+ * The state and the rare paths live here; the loop itself is compiled per
+ * search criterion in ScoredWorker.
  */
 class Worker
 {
    public:
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+    Worker(Worker&&) = delete;
+    Worker& operator=(Worker&&) = delete;
+
     /**
-     * @brief Constructs a Worker and initializes key generators and best key records.
-     * 
-     * Initializes the Ed25519 key generator, generates an initial key pair,
-     * sets up initial best key values, and initializes the global best key
-     * with a sentinel value (0xFF in first byte).
+     * @brief Destructor - securely cleans up the last batch
      */
-    Worker(const Settings& settings, size_t num,
-           ThreadSafeQueue<Candidate>* queue)
-        : settings_(settings), num_(num), queue_(queue)
-    {
-        // Generate initial random key pair
-        generator_.Generate(true);
-
-        best_.keys = generator_.Keys();
-        best_.zero_bits = LeadingZeroBits(best_.keys.public_key);
-    }
+    virtual ~Worker() { sodium_memzero(batch_.data(), sizeof(batch_)); }
 
     /**
      * @brief Main processing loop that generates and evaluates keys continuously.
      * 
-     * This method runs in a worker thread until a stop request is received.
-     * It generates Ed25519 key pairs and evaluates them against current best keys.
-     * Synchronizes with global best keys every 1000 generations.
+     * Runs in a worker thread until a stop request is received, see
+     * ScoredWorker::Process().
      * 
      * @param stoken Stop token for cooperative thread interruption.
      */
-    void Process(
-        std::stop_token stoken)  // NOLINT(performance-unnecessary-value-param)
+    virtual void Process(std::stop_token stoken) = 0;
+
+    /**
+     * @brief Tells whether Process() has returned.
+     */
+    bool Finished() const { return finished_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Gets the best candidate of this worker.
+     * 
+     * Only safe to call once Finished() is true; catches a best that is
+     * still waiting for room in the queue.
+     */
+    const Candidate& Best() const
     {
-        constexpr uint64_t SYNC_PERIOD = 1000;
-        while (!stoken.stop_requested()) {
-            ++generated_keys_count_;
+        assert(Finished());
+        return best_;
+    }
 
-            if ((generated_keys_count_ % SYNC_PERIOD) == 0) {
-                Sync();
-            }
+    /**
+     * @brief Gets the counters of this worker, updated after every batch.
+     */
+    const WorkerTelemetry& Telemetry() const { return telemetry_; }
 
-            generator_.Generate();
-            Candidate candidate;
-            candidate.keys = generator_.Keys();
-            candidate.zero_bits = LeadingZeroBits(candidate.keys.public_key);
-            if (settings_.ipv6_nice) {
-                candidate.addr = AddrForKey(candidate.keys.public_key);
-                candidate.ipv6_zero_blocks = AddressZeroBlocks(candidate.addr);
-            }
+    /// Keys per batch: enough to amortize the shared field inversion,
+    /// small enough to keep the stop request responsive.
+    static constexpr size_t BATCH_SIZE = 128;
+    static_assert(BATCH_SIZE % SCORE_BLOCK == 0);
 
-            if (candidate.IsBetter(best_, settings_.ipv6_nice)) {
-                NewBest(candidate);
-            }
+   protected:
+    /**
+     * @brief Constructs a Worker and initializes key engine and best key records.
+     * 
+     * Creates the key engine named in the settings (already resolved from
+     * "auto") and generates an initial key pair from the first seed of the
+     * worker's stream into the front of the batch; the derived class scores
+     * it.
+     */
+    Worker(const Settings& settings, size_t num, CandidateRing* queue,
+           const ScoreThreshold* threshold, Wakeup* wakeup,
+           LogPrinter::Ring* log)
+        : settings_(settings),
+          num_(num),
+          queue_(queue),
+          threshold_(threshold),
+          wakeup_(wakeup),
+          log_(log),
+          engine_(MakeKeyEngine(
+              settings.engine,
+              {.unsafe_vartime = settings.unsafe_vartime,
+               .table_shape = {.window = settings.table_window,
+                               .spacing = settings.table_spacing}}))
+    {
+        assert(engine_ != nullptr);
+        assert(threshold_ != nullptr);
+        assert(wakeup_ != nullptr);
+        assert(log_ != nullptr);
+
+        // Generate initial random key pair
+        auto& keys = batch_.front();
+        keys.seed = seeds_.Next();
+        engine_->Generate(std::span(&keys, 1));
+    }
+
+    Settings settings_;
+    size_t num_ = 0;
+    CandidateRing* queue_ = nullptr;
+    const ScoreThreshold* threshold_ = nullptr;  ///< global best rank
+    Wakeup* wakeup_ = nullptr;  ///< signals queued candidates and exit
+    LogPrinter::Ring* log_ = nullptr;  ///< verbose output of this worker
+    std::unique_ptr<KeyEngine> engine_;       ///< key pair derivation
+    IsaLevel isa_level_ = GetCpuFeatures().isa_level;  ///< kernel variant
+    bool simd_ = GetCpuFeatures().avx2;  ///< AVX2 score filters
+    SeedStream seeds_;                        ///< independent seeds
+    std::array<Keys_t, BATCH_SIZE> batch_{};  ///< current batch of keys
+    Candidate best_;          ///< best candidate found by this worker
+    bool unsent_ = false;     ///< best_ did not fit into the queue yet
+    uint64_t local_rank_ = 0;  ///< best rank seen by this worker
+    std::atomic<bool> finished_ = false;  ///< Process() has returned
+    WorkerTelemetry telemetry_;  ///< counters for the manager
+
+    /**
+     * @brief Updates local best records when a new better key is found.
+     * 
+     * Stores the seed and score in best_ and queues them for the manager.
+     * In verbose mode the candidate is also handed to the printer thread,
+     * which rebuilds and prints the key, so the worker never blocks on
+     * output.
+     * This method assumes the new key has already been validated as "better".
+     * Rare, so it stays out of the per-level copies of ScoreBatch().
+     */
+    [[gnu::noinline]] void NewBest(const Candidate& candidate)
+    {
+        best_ = candidate;
+        if (settings_.verbose) {
+            LogRecord record;
+            record.thread = static_cast<uint32_t>(num_);
+            record.candidate = best_;
+            record.time = std::chrono::steady_clock::now();
+            log_->try_push(record);
         }
+        Send();
     }
 
     /**
-     * @brief Gets the total number of keys generated by this worker.
+     * @brief Offers best_ to the manager.
      * 
-     * @return Count of generated keys (atomically updated every 1000 generations).
+     * If the queue is full, best_ is offered again after the next batch;
+     * newer bests replace it meanwhile, so a worker never has more than
+     * one candidate waiting.
      */
-    uint64_t GetGeneratedKeysCount() const
+    void Send()
     {
-        return local_generated_keys_count_;
+        unsent_ = not queue_->try_push(best_);
+        if (not unsent_) {
+            WorkerTelemetry::Add(telemetry_.candidates_pushed, 1);
+            wakeup_->release();
+        }
     }
+};
 
-   private:
-    Settings settings_;
-    size_t num_ = 0;
-    ThreadSafeQueue<Candidate>* queue_ = nullptr;
-    Ed25519_KeysGenerator generator_;  ///< key pair generator
-    Candidate best_;                   ///< best candidate found by this worker
-    mutable std::mutex mtx_;           ///< mutex for thread-safety
-    uint64_t generated_keys_count_ = 0;  ///< counter of generated keys
-    std::atomic<uint64_t> local_generated_keys_count_ = 0;
-    ///< thread-safe counter for external access
+/**
+ * @brief Worker whose loop is compiled for one scoring policy.
+ * 
+ * @tparam Scoring search criterion, see scoring.h
+ */
+template <typename Scoring>
+class ScoredWorker final : public Worker
+{
+   public:
+    /**
+     * @brief Constructs the worker and scores its initial key pair.
+     */
+    ScoredWorker(const Settings& settings, size_t num, CandidateRing* queue,
+                 const ScoreThreshold* threshold, Wakeup* wakeup,
+                 LogPrinter::Ring* log, Scoring scoring = {})
+        : Worker(settings, num, queue, threshold, wakeup, log),
+          scoring_(scoring)
+    {
+        const auto& keys = batch_.front();
+        best_ = scoring_.Score(keys.public_key);
+        best_.seed = keys.seed;
+        local_rank_ = Scoring::Rank(best_);
+    }
 
     /**
-     * @brief Synchronizes local with global
+     * @brief Main processing loop that generates and evaluates keys continuously.
      * 
-     * Updates the thread-safe generation counter.
-     * Called periodically (every 1000 generations).
+     * This method runs in a worker thread until a stop request is received.
+     * It derives Ed25519 key pairs for BATCH_SIZE fresh seeds at a time
+     * with the selected key engine and evaluates them against current best
+     * keys. Publishes the telemetry counters after every batch.
+     * 
+     * Keys are scored right after their y coordinate is encoded. The sign of
+     * x only lands in bit 255, which neither LeadingZeroBits() (unless the
+     * other 255 bits are zero) nor AddrForKey() can reach, so the y-only
+     * score is final. Keys are never completed here: a winner is passed on
+     * as its seed and score, and rebuilt from the seed when it is printed.
+     * 
+     * Derivation and scoring run in the kernel variants built for the
+     * x86-64 level of the CPU, see RunForIsa().
+     * 
+     * Every queued candidate and the final return wake the manager up.
+     * 
+     * @param stoken Stop token for cooperative thread interruption.
      */
-    void Sync() { local_generated_keys_count_ = generated_keys_count_; }
+    void Process(std::stop_token stoken)
+        override  // NOLINT(performance-unnecessary-value-param)
+    {
+        auto now = std::chrono::steady_clock::now();
+        while (!stoken.stop_requested()) {
+            seeds_.Fill(batch_);
+            now = WorkerTelemetry::AddSince(telemetry_.seeds_ns, now);
+            engine_->GeneratePartial(batch_);
+            now = WorkerTelemetry::AddSince(telemetry_.generate_ns, now);
+
+            RunForIsa(isa_level_, [this] { ScoreBatch(); });
+            if (unsent_) {
+                Send();
+            }
+            now = WorkerTelemetry::AddSince(telemetry_.score_ns, now);
+            WorkerTelemetry::Add(telemetry_.keys_tried, batch_.size());
+        }
+        finished_.store(true, std::memory_order_release);
+        wakeup_->release();
+    }
+
+   private:
+    Scoring scoring_;  ///< search criterion, with its parameters
 
     /**
-     * @brief Updates local best records when a new better key is found.
+     * @brief Scores the current batch in place and records winners.
      * 
-     * Updates the best public key and stores the complete key pair in local_best_keys_.
-     * This method assumes the new key has already been validated as "better".
+     * The policy is known at compile time, so the loop carries no mode
+     * checks and Score() and Rank() are inlined into it.
+     * Keys are first filtered SCORE_BLOCK at a time against the best rank
+     * seen so far, with AVX2 where available; only the few that pass are
+     * scored one by one. Only the seed of a winner is copied out of the
+     * batch.
+     * 
+     * A key must beat both the best seen by this worker and the global
+     * threshold, read once per batch, so workers stop queueing candidates
+     * that the manager already has something better than. Keys that only
+     * beat the former are counted as threshold rejects. Multi-target
+     * policies keep the best of every target themselves and skip the
+     * global threshold.
      */
-    void NewBest(const Candidate& candidate)
+    void ScoreBatch()
     {
-        best_ = candidate;
-        best_.addr = AddrForKey(best_.keys.public_key);
-        best_.zero_bits = LeadingZeroBits(best_.keys.public_key);
-        if (settings_.verbose) {
-            std::println("    thread {:3}: new best z={:2} | pub={} | ip={}",
-                         num_, best_.zero_bits, best_.keys.public_key.ToHex(),
-                         best_.addr.ToString());
+        const uint64_t global_rank = threshold_->Load();
+        uint64_t rejects = 0;
+        KeyBlock block;
+        for (size_t first = 0; first < batch_.size(); first += SCORE_BLOCK) {
+            const auto keys =
+                std::span(batch_).subspan(first).template first<SCORE_BLOCK>();
+            LoadKeyBlock<Scoring::KEY_WORDS>(keys, block);
+            for (ScoreMask mask = scoring_.Mask(block, local_rank_, simd_);
+                 mask != 0; mask &= mask - 1) {
+                const auto& key = keys[std::countr_zero(mask)];
+                if constexpr (Scoring::MULTI_TARGET) {
+                    scoring_.ForEachImproved(
+                        key.public_key, [this, &key](Candidate score) {
+                            score.seed = key.seed;
+                            NewBest(score);
+                        });
+                    continue;
+                }
+                Candidate score = scoring_.Score(key.public_key);
+                const uint64_t rank = Scoring::Rank(score);
+                if (rank > local_rank_) {
+                    local_rank_ = rank;
+                    if (rank > global_rank) {
+                        score.seed = key.seed;
+                        NewBest(score);
+                    }
+                    else {
+                        ++rejects;
+                    }
+                }
+            }
         }
-        const std::lock_guard locker(mtx_);
-        queue_->push_back(best_);
+        WorkerTelemetry::Add(telemetry_.threshold_rejects, rejects);
     }
 };
 
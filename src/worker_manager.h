@@ -1,9 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <optional>
 #include <print>
+#include <utility>
+#include <vector>
 
 #include "common.h"
-#include "thread_safe_queue.h"
+#include "log_printer.h"
+#include "score_threshold.h"
+#include "telemetry.h"
 #include "worker.h"
 
 namespace yggdrasil_cpp_genkeys
@@ -23,63 +32,63 @@ class WorkerManager
      * @brief Constructs a WorkerManager with specified runtime settings.
      * 
      * @param settings Configuration parameters including thread count and duration limits.
+     * @param pattern --pattern, already parsed, nullopt if not given
+     * @param pattern_set templates of --pattern-file, already read, null if
+     * not given
      */
-    explicit WorkerManager(const Settings& settings) : settings_(settings) {}
+    explicit WorkerManager(
+        const Settings& settings,
+        std::optional<AddressPattern> pattern = std::nullopt,
+        std::shared_ptr<const PatternSet> pattern_set = nullptr)
+        : settings_(settings),
+          pattern_(pattern),
+          pattern_set_(std::move(pattern_set)),
+          printer_(settings.threads_count + 1,
+                   ParseLogFormat(settings.output_format)
+                       .value_or(LogFormat::Text),
+                   settings.verbose)
+    {
+    }
 
     /**
      * @brief Main execution loop that runs workers and manages key evaluation.
      * 
      * This method:
      * 1. Starts all worker threads
-     * 2. Periodically polls workers for their best keys
-     * 3. Updates global best key when a better one is found
-     * 4. Stops automatically when duration limit is reached
-     * 5. Handles graceful thread termination
+     * 2. Sleeps until a worker queues a candidate, Stop() is called or the
+     *    duration limit expires, whichever comes first
+     * 3. Drains every queued candidate on each wake-up, updates global best
+     *    key when a better one is found and publishes its score to the
+     *    workers
+     * 4. Stops automatically when duration limit or target is reached, see
+     *    TargetReached()
+     * 5. Joins the workers and flushes the candidates they still hold
      */
     void Run()
     {
         RunWorkers();
 
-        int count = 0;
         start_time_ = std::chrono::steady_clock::now();
-
-        constexpr auto SYNC_PERIOD = std::chrono::milliseconds(100);
+        const auto deadline =
+            start_time_ + std::chrono::seconds(settings_.max_duration);
 
         // Main coordination loop
         while (not stop_) {
-            ++count;
-            std::this_thread::sleep_for(SYNC_PERIOD);
-
-            bool new_best = false;
-            auto best = queue_.try_pop_front();
-            if (best.has_value()) {
-                if ((*best).IsBetter(global_best_, settings_.ipv6_nice)) {
-                    global_best_ = *best;
-                    new_best = true;
+            if (settings_.max_duration != 0) {
+                if (not wakeup_.try_acquire_until(deadline)) {
+                    Stop();
                 }
             }
-
-            if (new_best) {
-                PrintBest();
+            else {
+                wakeup_.acquire();
             }
 
-            // Check duration limit if specified
-            if (settings_.max_duration != 0) {
-                const auto now = std::chrono::steady_clock::now();
-                const auto elapsed = static_cast<uint64_t>(
-                    duration_cast<std::chrono::duration<double>>(now -
-                                                                 start_time_)
-                        .count());
-                if (elapsed > settings_.max_duration) {
-                    Stop();
-                }
+            if (Drain()) {
+                PrintBest();
             }
 
-            // Check target leading zeros is reached
-            if (settings_.target_leading_zeros != 0) {
-                if (global_best_.zero_bits >= settings_.target_leading_zeros) {
-                    Stop();
-                }
+            if (TargetReached()) {
+                Stop();
             }
         }
 
@@ -89,34 +98,59 @@ class WorkerManager
     /**
      * @brief Signals the manager to stop processing.
      * 
-     * Sets the stop flag which will cause the main loop to exit.
-     * This can be called from another thread or from within the loop
-     * (e.g., when duration limit is reached).
+     * Sets the stop flag and wakes the main loop, which then exits.
+     * This can be called from another thread, from within the loop
+     * (e.g., when duration limit is reached) or from a signal handler:
+     * releasing the semaphore is a lock-free atomic increment and a futex
+     * wake.
      */
-    void Stop() { stop_ = true; }
+    void Stop()
+    {
+        stop_ = true;
+        wakeup_.release();
+    }
 
    private:
     using WorkerPtr = std::unique_ptr<Worker>;
 
     Settings settings_;                  ///< runtime configuration parameters
+    std::optional<AddressPattern> pattern_;  ///< parsed --pattern
+    std::shared_ptr<const PatternSet> pattern_set_;  ///< --pattern-file
     std::vector<WorkerPtr> workers_;     ///< managed worker instances
     std::vector<std::jthread> threads_;  ///< thread handles for workers
     Candidate global_best_;              ///< current global best
+    std::vector<Candidate> target_best_;  ///< per template of a pattern file
+    uint64_t (*rank_)(const Candidate&) = nullptr;  ///< Scoring::Rank()
     std::atomic<bool> stop_ = false;     ///< flag to signal termination
     std::chrono::steady_clock::time_point start_time_;  ///< start time
-    ThreadSafeQueue<Candidate> queue_;  ///< queue for best candidates
+    CandidateRing queue_;               ///< queue for best candidates
+    ScoreThreshold threshold_;          ///< score of global_best_ for workers
+    Wakeup wakeup_{0};  ///< candidates, finished workers and Stop() calls
+    LogPrinter printer_;  ///< output, one ring per worker plus the manager
 
     /**
      * @brief Creates and starts worker threads.
      * 
-     * Instantiates the specified number of Worker objects and launches
-     * their process() methods in separate threads using std::jthread.
+     * Instantiates the specified number of Worker objects, specialized for
+     * the search criterion of the settings, and launches their process()
+     * methods in separate threads using std::jthread.
      */
     void RunWorkers()
     {
-        for (size_t i = 0; i < settings_.threads_count; ++i) {
-            workers_.push_back(std::make_unique<Worker>(settings_, i, &queue_));
+        if (pattern_set_ != nullptr) {
+            target_best_.resize(pattern_set_->Size());
+            MakeWorkers(MultiPatternScoring(pattern_set_));
+        }
+        else if (pattern_.has_value()) {
+            MakeWorkers(PatternScoring{.pattern = *pattern_});
         }
+        else if (settings_.ipv6_nice) {
+            MakeWorkers<Ipv6NiceScoring>();
+        }
+        else {
+            MakeWorkers<LeadingZerosScoring>();
+        }
+        printer_.Start();
 
         for (auto& worker : workers_) {
             threads_.emplace_back(
@@ -125,20 +159,130 @@ class WorkerManager
     }
 
     /**
-     * @brief Stops all worker threads gracefully.
+     * @brief Creates the workers for one scoring policy, each with a copy
+     * of @p scoring, and ranks candidates by it from now on.
+     */
+    template <typename Scoring>
+    void MakeWorkers(const Scoring& scoring = {})
+    {
+        rank_ = &Scoring::Rank;
+        for (size_t i = 0; i < settings_.threads_count; ++i) {
+            workers_.push_back(std::make_unique<ScoredWorker<Scoring>>(
+                settings_, i, &queue_, &threshold_, &wakeup_,
+                printer_.RingFor(i), scoring));
+        }
+    }
+
+    /**
+     * @brief Merges every queued candidate into the global best.
      * 
-     * Requests stop on all worker threads and waits briefly for them to finish.
-     * Uses cooperative interruption via std::stop_token.
+     * @return true if the global best improved
+     */
+    bool Drain()
+    {
+        bool new_best = false;
+        while (auto best = queue_.try_pop()) {
+            new_best |= Merge(*best);
+        }
+        return new_best;
+    }
+
+    /**
+     * @brief Makes @p candidate the global best if it ranks higher by the
+     * scoring policy of the workers.
+     * 
+     * With a pattern file the candidate competes with the best of its
+     * template instead and is printed right away if it wins.
+     * 
+     * @return true if the global best improved
+     */
+    bool Merge(const Candidate& candidate)
+    {
+        if (not target_best_.empty()) {
+            auto& best = target_best_.at(candidate.target);
+            if (candidate.pattern_match and (rank_(candidate) > rank_(best))) {
+                best = candidate;
+                PrintResult(best);
+            }
+            return false;
+        }
+        const uint64_t rank = rank_(candidate);
+        if (rank <= rank_(global_best_)) {
+            return false;
+        }
+        global_best_ = candidate;
+        threshold_.Raise(rank);
+        return true;
+    }
+
+    /**
+     * @brief Stops all worker threads and collects their last candidates.
+     * 
+     * Requests stop on all worker threads and joins them. A worker checks
+     * its stop token after every batch of Worker::BATCH_SIZE keys, so the
+     * wait is bounded by one batch. Workers are always joined, never
+     * detached, because they point into the queue, the threshold, the
+     * semaphore and the printer rings owned by this manager. The best
+     * candidates of the workers are merged, including any still waiting
+     * for room in the queue, and printed if they beat the global best.
+     * Finally the printer writes everything still pending.
      */
     void StopWorkers()
     {
         for (auto& thread : threads_) {
             thread.request_stop();
         }
+        for (auto& thread : threads_) {
+            thread.join();
+        }
 
-        constexpr auto WAIT_FOR_STOP = std::chrono::milliseconds(500);
+        bool new_best = Drain();
+        for (const auto& worker : workers_) {
+            new_best |= Merge(worker->Best());
+        }
 
-        std::this_thread::sleep_for(WAIT_FOR_STOP);
+        if (new_best) {
+            PrintBest();
+        }
+        printer_.Stop();
+    }
+
+    /**
+     * @brief Tells whether the search is complete.
+     * 
+     * That is when the best key has --target-zeros leading zero bits, else
+     * at the first --pattern match; with a pattern file when every template
+     * has such a match.
+     */
+    bool TargetReached() const
+    {
+        const auto reached = [this](const Candidate& best) {
+            if (settings_.target_leading_zeros != 0) {
+                return best.zero_bits >= settings_.target_leading_zeros;
+            }
+            return best.pattern_match;
+        };
+        if (not target_best_.empty()) {
+            return std::ranges::all_of(target_best_, [&reached](const auto& b) {
+                return b.pattern_match and reached(b);
+            });
+        }
+        return reached(global_best_);
+    }
+
+    /**
+     * @brief Sums the counters of all workers.
+     * 
+     * Relaxed reads of blocks that only their owners write, so this never
+     * slows the workers down; the sum may mix batches of different workers.
+     */
+    TelemetrySnapshot ReadTelemetry() const
+    {
+        TelemetrySnapshot total;
+        for (const auto& worker : workers_) {
+            total += worker->Telemetry().Read();
+        }
+        return total;
     }
 
     /**
@@ -146,37 +290,36 @@ class WorkerManager
      * 
      * Displays:
      * - Elapsed time and total keys generated
-     * - Generation rate (keys per second)
+     * - Generation rate (keys per second) and, in verbose mode, worker
+     *   telemetry
      * - Best secret key in hex format
      * - Best public key in hex format
      * - Derived IP address for the key (if applicable)
+     *
+     * The statistics are taken here; formatting, rebuilding the key pair
+     * from the seed and writing happen on the printer thread.
      */
-    void PrintBest()
-    {
-        uint64_t generated_keys_count = 0;
+    void PrintBest() { PrintResult(global_best_); }
 
-        for (auto& worker : workers_) {
-            generated_keys_count += worker->GetGeneratedKeysCount();
-        }
-
-        const auto now = std::chrono::steady_clock::now();
-        const auto duration =
-            duration_cast<std::chrono::duration<double>>(now - start_time_);
-        const auto elapsed = static_cast<uint64_t>(duration.count());
-        if (elapsed > 0) {
-            const auto rate = generated_keys_count / elapsed;
-            std::println("----- {} --- {} keys tried",
-                         format_duration_go_style(duration),
-                         generated_keys_count);
-            if (settings_.verbose) {
-                std::println("----- generation speed {} keys per second", rate);
-            }
-        }
-
-        std::println("Priv: {}", global_best_.keys.secret_key.ToHex());
-        std::println("Pub: {}", global_best_.keys.public_key.ToHex());
-        std::println("IP: {}",
-                     AddrForKey(global_best_.keys.public_key).ToString());
+    /**
+     * @brief Prints @p candidate as a result, see PrintBest().
+     * 
+     * Results are never dropped: if the manager's ring is full this waits
+     * until the printer thread has made room.
+     */
+    void PrintResult(const Candidate& candidate)
+    {
+        LogRecord record;
+        record.kind = LogRecord::Kind::Result;
+        record.candidate = candidate;
+        record.time = std::chrono::steady_clock::now();
+        record.elapsed_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(record.time -
+                                                                 start_time_)
+                .count());
+        record.telemetry = ReadTelemetry();
+        record.queue_overflows = queue_.Overflows();
+        printer_.RingFor(settings_.threads_count)->push(record);
     }
 };
 
@@ -1,20 +1,53 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <span>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "../../src/bytes.h"
+#include "../../src/candidate.h"
 #include "../../src/compare.h"
 #include "../../src/ed25519_keys.h"
 #include "../../src/ed25519_keys_generator.h"
+#include "../../src/ge25519_64.h"
+#include "../../src/ge25519_base_table.h"
+#include "../../src/ge25519_interleaved.h"
+#include "../../src/ge25519_x4.h"
+#include "../../src/key_engine.h"
+#include "../../src/log_printer.h"
+#include "../../src/mpsc_ring.h"
+#include "../../src/pattern_set.h"
+#include "../../src/score_batch.h"
+#include "../../src/score_threshold.h"
+#include "../../src/scoring.h"
+#include "../../src/seed_stream.h"
+#include "../../src/sha512.h"
+#include "../../src/sha512_x4.h"
+#include "../../src/spsc_ring.h"
+#include "../../src/table_storage.h"
+#include "../../src/telemetry.h"
+#include "../../src/worker.h"
 
 using yggdrasil_cpp_genkeys::BytesToHex;
 using yggdrasil_cpp_genkeys::Ed25519_KeysGenerator;
 using yggdrasil_cpp_genkeys::HexToBytes;
+using yggdrasil_cpp_genkeys::Keys_t;
 using yggdrasil_cpp_genkeys::PublicKey_t;
 using yggdrasil_cpp_genkeys::Seed_t;
+using yggdrasil_cpp_genkeys::Sha512Digest;
 
 struct TestKeys
 {
@@ -130,6 +163,49 @@ std::vector<TestKeys> test_data = {
          "000005a10b587db1d8ce75cf8d8f4988362069ec411f751a6a15f5b030911ea6",
      .ipv6_hex = "215:97bd:29e0:9389:cc62:8c1c:9c2d:9df2"}};
 
+/// The original bit-by-bit AddrForKey(), the reference for the word-level
+/// one
+yggdrasil_cpp_genkeys::IPv6_Addr ReferenceAddrForKey(
+    const PublicKey_t& public_key)
+{
+    std::array<uint8_t, PublicKey_t::Size> inverted{};
+    for (size_t i = 0; i < PublicKey_t::Size; ++i) {
+        inverted[i] = ~public_key.bytes[i];
+    }
+
+    yggdrasil_cpp_genkeys::IPv6_Addr addr{};
+    std::vector<uint8_t> temp;
+    bool done = false;
+    uint8_t ones = 0;
+    uint8_t bits = 0;
+    int n_bits = 0;
+    for (int idx = 0; idx < 8 * static_cast<int>(inverted.size()); ++idx) {
+        const uint8_t bit =
+            (inverted[idx / 8] & (0x80 >> (idx % 8))) >> (7 - (idx % 8));
+        if (!done and (bit != 0)) {
+            ++ones;
+            continue;
+        }
+        if (!done and (bit == 0)) {
+            done = true;
+            continue;
+        }
+        bits = (bits << 1) | bit;
+        ++n_bits;
+        if (n_bits == 8) {
+            n_bits = 0;
+            temp.push_back(bits);
+            bits = 0;
+        }
+    }
+
+    addr.bytes[0] = 0x02;
+    addr.bytes[1] = ones;
+    std::copy_n(temp.begin(), std::min<size_t>(temp.size(), 14),
+                addr.bytes.begin() + 2);
+    return addr;
+}
+
 }  // anonymous namespace
 
 TEST(YggdrasilCppGetkeys, KeysGeneration)
@@ -146,6 +222,1271 @@ TEST(YggdrasilCppGetkeys, KeysGeneration)
     }
 }
 
+TEST(YggdrasilCppGetkeys, BatchGeneration)
+{
+    Ed25519_KeysGenerator gen;
+    std::vector<Keys_t> batch(test_data.size());
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        batch[i].seed.FromHex(test_data[i].secret_hex.substr(0, 64));
+    }
+    gen.GenerateBatchFromSeeds(batch);
+    for (size_t i = 0; i < test_data.size(); ++i) {
+        ASSERT_EQ(batch[i].secret_key.ToHex(), test_data[i].secret_hex);
+        ASSERT_EQ(batch[i].public_key.ToHex(), test_data[i].public_hex);
+    }
+}
+
+TEST(YggdrasilCppGetkeys, BatchGenerationMatchesLibsodium)
+{
+    Ed25519_KeysGenerator batch_gen;
+    Ed25519_KeysGenerator single_gen;
+    batch_gen.Generate(true);
+
+    for (const size_t batch_size : {1, 2, 7, 64, 129}) {
+        std::vector<Keys_t> batch(batch_size);
+        batch_gen.GenerateBatch(batch);
+        for (auto& keys : batch) {
+            single_gen.Generate(keys.seed);
+            ASSERT_EQ(keys.public_key.ToHex(),
+                      single_gen.Keys().public_key.ToHex());
+            ASSERT_EQ(keys.secret_key.ToHex(),
+                      single_gen.Keys().secret_key.ToHex());
+        }
+    }
+}
+
+TEST(YggdrasilCppGetkeys, PartialBatchGeneration)
+{
+    Ed25519_KeysGenerator batch_gen;
+    Ed25519_KeysGenerator single_gen;
+    batch_gen.Generate(true);
+
+    std::vector<Keys_t> batch(67);
+    batch_gen.GenerateBatchPartial(batch);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto& keys = batch[i];
+        const auto zero_bits = LeadingZeroBits(keys.public_key);
+        const auto addr = AddrForKey(keys.public_key).ToString();
+
+        batch_gen.CompleteBatchKey(i, keys);
+        single_gen.Generate(keys.seed);
+        ASSERT_EQ(keys.public_key.ToHex(),
+                  single_gen.Keys().public_key.ToHex());
+        ASSERT_EQ(keys.secret_key.ToHex(),
+                  single_gen.Keys().secret_key.ToHex());
+        // the score of the y-only encoding is final
+        ASSERT_EQ(zero_bits, LeadingZeroBits(keys.public_key));
+        ASSERT_EQ(addr, AddrForKey(keys.public_key).ToString());
+    }
+}
+
+TEST(YggdrasilCppGetkeys, KeyEnginesMatchLibsodium)
+{
+    using yggdrasil_cpp_genkeys::FindKeyEngine;
+    using yggdrasil_cpp_genkeys::GetCpuFeatures;
+    using yggdrasil_cpp_genkeys::IsaLevel;
+    using yggdrasil_cpp_genkeys::IsaLevelName;
+    using yggdrasil_cpp_genkeys::KEY_ENGINE_AUTO;
+    using yggdrasil_cpp_genkeys::KeyEngines;
+    using yggdrasil_cpp_genkeys::MakeKeyEngine;
+
+    Ed25519_KeysGenerator single_gen;
+    single_gen.Generate(true);
+    std::vector<Keys_t> batch(37);
+    for (auto& keys : batch) {
+        single_gen.Generate();
+        keys.seed = single_gen.Keys().seed;
+    }
+
+    for (const auto& info : KeyEngines()) {
+        auto engine = MakeKeyEngine(info.name);
+        if (not info.available()) {
+            ASSERT_EQ(engine, nullptr);
+            continue;
+        }
+        ASSERT_NE(engine, nullptr);
+        // every kernel variant the CPU can run, from the baseline up
+        const auto top = static_cast<int>(GetCpuFeatures().isa_level);
+        for (int run = 0; run <= 2 * top + 1; ++run) {
+            const bool vartime = (run % 2) == 1;
+            const int level = run / 2;
+            auto tuned =
+                info.make({.unsafe_vartime = vartime,
+                           .table_shape = {.window = 5, .spacing = 1},
+                           .isa_level = static_cast<IsaLevel>(level)});
+            tuned->GeneratePartial(batch);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                auto& keys = batch[i];
+                const auto zero_bits = LeadingZeroBits(keys.public_key);
+                tuned->Complete(i, keys);
+                single_gen.Generate(keys.seed);
+                ASSERT_EQ(keys.public_key.ToHex(),
+                          single_gen.Keys().public_key.ToHex())
+                    << info.name << " "
+                    << IsaLevelName(static_cast<IsaLevel>(level));
+                ASSERT_EQ(keys.secret_key.ToHex(),
+                          single_gen.Keys().secret_key.ToHex())
+                    << info.name;
+                ASSERT_EQ(zero_bits, LeadingZeroBits(keys.public_key));
+            }
+        }
+    }
+
+    ASSERT_EQ(MakeKeyEngine("no-such-engine"), nullptr);
+    ASSERT_EQ(FindKeyEngine(KEY_ENGINE_AUTO), nullptr);
+}
+
+TEST(YggdrasilCppGetkeys, KeyEngineCalibration)
+{
+    using yggdrasil_cpp_genkeys::CalibrateKeyEngines;
+    using yggdrasil_cpp_genkeys::FastestKeyEngine;
+    using yggdrasil_cpp_genkeys::KeyEngines;
+    using yggdrasil_cpp_genkeys::MakeKeyEngine;
+
+    const auto rates =
+        CalibrateKeyEngines({}, std::chrono::milliseconds(5), 16);
+    const auto available = std::ranges::count_if(
+        KeyEngines(), [](const auto& info) { return info.available(); });
+    ASSERT_EQ(rates.size(), static_cast<size_t>(available));
+    for (const auto& rate : rates) {
+        ASSERT_GT(rate.keys_per_second, 0) << rate.name;
+    }
+    ASSERT_NE(MakeKeyEngine(FastestKeyEngine(rates)), nullptr);
+}
+
+TEST(YggdrasilCppGetkeys, ScalarMultBaseX4MatchesLibsodium)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (!yggdrasil_cpp_genkeys::GetCpuFeatures().avx2) {
+        GTEST_SKIP() << "AVX2 is not supported by this CPU";
+    }
+
+    using yggdrasil_cpp_genkeys::GE_X4_LANES;
+    using yggdrasil_cpp_genkeys::GeP3;
+    for (int round = 0; round < 16; ++round) {
+        std::array<Keys_t, GE_X4_LANES> expected{};
+        std::array<std::array<uint8_t, 32>, GE_X4_LANES> scalars{};
+        std::array<GeP3, GE_X4_LANES> points{};
+        std::array<GeP3*, GE_X4_LANES> point_ptrs{};
+        for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+            auto& keys = expected[lane];
+            randombytes_buf(keys.seed.data(), keys.seed.size());
+            crypto_sign_ed25519_seed_keypair(keys.public_key.data(),
+                                             keys.secret_key.data(),
+                                             keys.seed.data());
+            Sha512Digest hash{};
+            crypto_hash_sha512(hash.data(), keys.seed.data(), keys.seed.size());
+            std::copy_n(hash.begin(), 32, scalars[lane].begin());
+            scalars[lane][0] &= 248;
+            scalars[lane][31] &= 127;
+            scalars[lane][31] |= 64;
+            point_ptrs[lane] = &points[lane];
+        }
+
+        yggdrasil_cpp_genkeys::GeScalarMultBaseX4(
+            {scalars[0], scalars[1], scalars[2], scalars[3]}, point_ptrs);
+
+        for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+            PublicKey_t public_key;
+            yggdrasil_cpp_genkeys::GeEncode(
+                points[lane], yggdrasil_cpp_genkeys::FeInvert(points[lane].z),
+                public_key.bytes);
+            ASSERT_EQ(public_key.ToHex(), expected[lane].public_key.ToHex());
+        }
+    }
+#else
+    GTEST_SKIP() << "AVX2 kernels are x86 only";
+#endif
+}
+
+TEST(YggdrasilCppGetkeys, Fe64MatchesRadix51)
+{
+#if defined(__x86_64__)
+    if (!yggdrasil_cpp_genkeys::Ed25519_BatchEngine::MulxSupported()) {
+        GTEST_SKIP() << "BMI2/ADX is not supported by this CPU";
+    }
+
+    using yggdrasil_cpp_genkeys::Fe64;
+    using yggdrasil_cpp_genkeys::Fe64ToFe;
+    using yggdrasil_cpp_genkeys::FeToBytes;
+
+    const auto bytes = [](const Fe64& f) { return FeToBytes(Fe64ToFe(f)); };
+
+    constexpr uint64_t ONES = ~uint64_t{0};
+    std::vector<Fe64> values{
+        {},
+        {{1, 0, 0, 0}},
+        {{ONES, ONES, ONES, ONES}},                        // 2^256 - 1
+        {{ONES - 18, ONES, ONES, ONES >> 1}},              // p - 1
+        {{ONES - 37, ONES, ONES, ONES}},                   // 2 * p
+        {{ONES, ONES, ONES, ONES >> 1}},                   // 2^255 - 1
+        {{0, 0, 0, uint64_t{1} << 63}},                    // 2^255
+    };
+    for (int i = 0; i < 64; ++i) {
+        Fe64 f;
+        randombytes_buf(f.v.data(), sizeof(f.v));
+        values.push_back(f);
+    }
+
+    for (const auto& f : values) {
+        const auto f51 = Fe64ToFe(f);
+        ASSERT_EQ(bytes(yggdrasil_cpp_genkeys::Fe64FromFe(f51)), bytes(f));
+        ASSERT_EQ(bytes(yggdrasil_cpp_genkeys::Fe64Sq(f)),
+                  FeToBytes(yggdrasil_cpp_genkeys::FeSq(f51)));
+        ASSERT_EQ(bytes(yggdrasil_cpp_genkeys::Fe64Neg(f)),
+                  FeToBytes(yggdrasil_cpp_genkeys::FeNeg(f51)));
+        for (const auto& g : values) {
+            const auto g51 = Fe64ToFe(g);
+            ASSERT_EQ(bytes(yggdrasil_cpp_genkeys::Fe64Mul(f, g)),
+                      FeToBytes(yggdrasil_cpp_genkeys::FeMul(f51, g51)));
+            ASSERT_EQ(bytes(yggdrasil_cpp_genkeys::Fe64Add(f, g)),
+                      FeToBytes(yggdrasil_cpp_genkeys::FeAdd(f51, g51)));
+            ASSERT_EQ(bytes(yggdrasil_cpp_genkeys::Fe64Sub(f, g)),
+                      FeToBytes(yggdrasil_cpp_genkeys::FeSub(f51, g51)));
+        }
+    }
+#else
+    GTEST_SKIP() << "mulx kernels are x86-64 only";
+#endif
+}
+
+TEST(YggdrasilCppGetkeys, ScalarMultBase64MatchesRadix51)
+{
+#if defined(__x86_64__)
+    if (!yggdrasil_cpp_genkeys::Ed25519_BatchEngine::MulxSupported()) {
+        GTEST_SKIP() << "BMI2/ADX is not supported by this CPU";
+    }
+
+    using yggdrasil_cpp_genkeys::FeInvert;
+    using yggdrasil_cpp_genkeys::GeEncode;
+    using yggdrasil_cpp_genkeys::GeP3;
+
+    const auto encode = [](const GeP3& point) {
+        PublicKey_t public_key;
+        GeEncode(point, FeInvert(point.z), public_key.bytes);
+        return public_key.ToHex();
+    };
+
+    for (int round = 0; round < 32; ++round) {
+        std::array<uint8_t, 32> scalar{};
+        randombytes_buf(scalar.data(), scalar.size());
+        scalar[31] &= 127;
+        if (round == 0) {
+            scalar.fill(0);
+        }
+        const auto expected =
+            encode(yggdrasil_cpp_genkeys::GeScalarMultBase(scalar));
+        ASSERT_EQ(encode(yggdrasil_cpp_genkeys::GeScalarMultBase64(scalar)),
+                  expected);
+        ASSERT_EQ(
+            encode(yggdrasil_cpp_genkeys::GeScalarMultBase64Vartime(scalar)),
+            expected);
+    }
+#else
+    GTEST_SKIP() << "mulx kernels are x86-64 only";
+#endif
+}
+
+TEST(YggdrasilCppGetkeys, InterleavedScalarMultBase)
+{
+    using yggdrasil_cpp_genkeys::FeInvert;
+    using yggdrasil_cpp_genkeys::GeEncode;
+    using yggdrasil_cpp_genkeys::GeP3;
+
+    const auto encode = [](const GeP3& point) {
+        PublicKey_t public_key;
+        GeEncode(point, FeInvert(point.z), public_key.bytes);
+        return public_key.ToHex();
+    };
+
+    const auto check = [&encode]<size_t N>() {
+        std::array<std::array<uint8_t, 32>, N> scalars{};
+        std::array<GeP3, N> points{};
+        std::array<GeP3, N> points_vartime{};
+        std::array<GeP3*, N> point_ptrs{};
+        std::array<GeP3*, N> point_ptrs_vartime{};
+        for (size_t l = 0; l < N; ++l) {
+            randombytes_buf(scalars[l].data(), scalars[l].size());
+            scalars[l][31] &= 127;
+            point_ptrs[l] = &points[l];
+            point_ptrs_vartime[l] = &points_vartime[l];
+        }
+        scalars[N - 1].fill(0);  // neutral element in one lane
+        yggdrasil_cpp_genkeys::GeScalarMultBaseInterleaved(scalars, point_ptrs);
+        yggdrasil_cpp_genkeys::GeScalarMultBaseInterleavedVartime(
+            scalars, point_ptrs_vartime);
+        for (size_t l = 0; l < N; ++l) {
+            const auto expected =
+                encode(yggdrasil_cpp_genkeys::GeScalarMultBase(scalars[l]));
+            ASSERT_EQ(encode(points[l]), expected);
+            ASSERT_EQ(encode(points_vartime[l]), expected);
+        }
+    };
+    for (int round = 0; round < 8; ++round) {
+        check.template operator()<2>();
+        check.template operator()<4>();
+    }
+
+    // groups of four, a pair and a single key per batch
+    Ed25519_KeysGenerator batch_gen;
+    Ed25519_KeysGenerator single_gen;
+    batch_gen.SetInterleave(4);
+    batch_gen.Generate(true);
+    std::vector<Keys_t> batch(11);
+    batch_gen.GenerateBatch(batch);
+    for (auto& keys : batch) {
+        single_gen.Generate(keys.seed);
+        ASSERT_EQ(keys.secret_key.ToHex(),
+                  single_gen.Keys().secret_key.ToHex());
+    }
+}
+
+TEST(YggdrasilCppGetkeys, VartimeMatchesConstantTime)
+{
+    using yggdrasil_cpp_genkeys::FeInvert;
+    using yggdrasil_cpp_genkeys::GeEncode;
+    using yggdrasil_cpp_genkeys::GeP3;
+
+    const auto encode = [](const GeP3& point) {
+        PublicKey_t public_key;
+        GeEncode(point, FeInvert(point.z), public_key.bytes);
+        return public_key.ToHex();
+    };
+
+    for (int round = 0; round < 64; ++round) {
+        std::array<uint8_t, 32> scalar{};
+        randombytes_buf(scalar.data(), scalar.size());
+        // sparse scalars exercise zero and negative digits
+        if (round % 2 == 1) {
+            for (size_t i = 0; i < scalar.size(); ++i) {
+                scalar[i] &= (i % 3 == 0) ? 0x00 : 0x8F;
+            }
+        }
+        scalar[31] &= 127;
+        const auto vartime =
+            yggdrasil_cpp_genkeys::GeScalarMultBaseVartime(scalar);
+        ASSERT_EQ(encode(vartime),
+                  encode(yggdrasil_cpp_genkeys::GeScalarMultBase(scalar)));
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (yggdrasil_cpp_genkeys::GetCpuFeatures().avx2) {
+        using yggdrasil_cpp_genkeys::GE_X4_LANES;
+        std::array<std::array<uint8_t, 32>, GE_X4_LANES> scalars{};
+        std::array<GeP3, GE_X4_LANES> points{};
+        std::array<GeP3*, GE_X4_LANES> point_ptrs{};
+        for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+            randombytes_buf(scalars[lane].data(), scalars[lane].size());
+            scalars[lane][31] &= 127;
+            point_ptrs[lane] = &points[lane];
+        }
+        scalars[1].fill(0);  // neutral element in one lane
+        yggdrasil_cpp_genkeys::GeScalarMultBaseX4Vartime(
+            {scalars[0], scalars[1], scalars[2], scalars[3]}, point_ptrs);
+        for (size_t lane = 0; lane < GE_X4_LANES; ++lane) {
+            ASSERT_EQ(encode(points[lane]),
+                      encode(yggdrasil_cpp_genkeys::GeScalarMultBase(
+                          scalars[lane])));
+        }
+    }
+#endif
+
+    Ed25519_KeysGenerator batch_gen;
+    Ed25519_KeysGenerator single_gen;
+    batch_gen.SetUnsafeVartime(true);
+    batch_gen.Generate(true);
+    for (const size_t batch_size : {1, 7, 64}) {
+        std::vector<Keys_t> batch(batch_size);
+        batch_gen.GenerateBatch(batch);
+        for (auto& keys : batch) {
+            single_gen.Generate(keys.seed);
+            ASSERT_EQ(keys.secret_key.ToHex(),
+                      single_gen.Keys().secret_key.ToHex());
+        }
+    }
+}
+
+TEST(YggdrasilCppGetkeys, BaseTableShapes)
+{
+    using yggdrasil_cpp_genkeys::FeInvert;
+    using yggdrasil_cpp_genkeys::GeBaseTable;
+    using yggdrasil_cpp_genkeys::GeEncode;
+    using yggdrasil_cpp_genkeys::GeP3;
+    using yggdrasil_cpp_genkeys::GeTableShape;
+
+    const auto encode = [](const GeP3& point) {
+        PublicKey_t public_key;
+        GeEncode(point, FeInvert(point.z), public_key.bytes);
+        return public_key.ToHex();
+    };
+
+    std::array<std::array<uint8_t, 32>, 4> scalars{};
+    for (auto& scalar : scalars) {
+        randombytes_buf(scalar.data(), scalar.size());
+        scalar[31] &= 127;
+    }
+    scalars[1].fill(0xFF);  // every digit carries
+    scalars[1][31] = 127;
+
+    for (const GeTableShape shape : {GeTableShape{2, 1}, GeTableShape{3, 5},
+                                     GeTableShape{5, 1}, GeTableShape{6, 3},
+                                     GeTableShape{8, 2}, GeTableShape{12, 8}}) {
+        ASSERT_TRUE(shape.IsValid());
+        const GeBaseTable& table = yggdrasil_cpp_genkeys::GetBaseTable(shape);
+        for (const auto& scalar : scalars) {
+            const auto expected =
+                encode(yggdrasil_cpp_genkeys::GeScalarMultBase(scalar));
+            ASSERT_EQ(encode(yggdrasil_cpp_genkeys::GeScalarMultBase(
+                          scalar, table)),
+                      expected);
+            ASSERT_EQ(encode(yggdrasil_cpp_genkeys::GeScalarMultBaseVartime(
+                          scalar, table)),
+                      expected);
+        }
+
+#if defined(__x86_64__) || defined(__i386__)
+        if (yggdrasil_cpp_genkeys::GetCpuFeatures().avx2) {
+            std::array<GeP3, 4> points{};
+            std::array<GeP3*, 4> point_ptrs{&points[0], &points[1],
+                                            &points[2], &points[3]};
+            const std::array<std::span<const uint8_t, 32>, 4> spans{
+                scalars[0], scalars[1], scalars[2], scalars[3]};
+            for (const bool vartime : {false, true}) {
+                if (vartime) {
+                    yggdrasil_cpp_genkeys::GeScalarMultBaseX4Vartime(
+                        spans, point_ptrs, table);
+                }
+                else {
+                    yggdrasil_cpp_genkeys::GeScalarMultBaseX4(
+                        spans, point_ptrs, table);
+                }
+                for (size_t lane = 0; lane < points.size(); ++lane) {
+                    ASSERT_EQ(encode(points[lane]),
+                              encode(yggdrasil_cpp_genkeys::GeScalarMultBase(
+                                  scalars[lane])));
+                }
+            }
+        }
+#endif
+    }
+
+    ASSERT_FALSE((GeTableShape{1, 2}.IsValid()));
+    ASSERT_FALSE((GeTableShape{13, 2}.IsValid()));
+    ASSERT_FALSE((GeTableShape{4, 0}.IsValid()));
+    ASSERT_FALSE((GeTableShape{4, 9}.IsValid()));
+}
+
+TEST(YggdrasilCppGetkeys, BaseTableCache)
+{
+    using yggdrasil_cpp_genkeys::GeBaseTable;
+    using yggdrasil_cpp_genkeys::GePrecomp;
+    using yggdrasil_cpp_genkeys::GeTableShape;
+    using yggdrasil_cpp_genkeys::SaveTableCache;
+
+    const auto dir = std::filesystem::path(testing::TempDir()) /
+                     std::format("table-cache-{}", randombytes_random());
+    const GeTableShape shape{.window = 5, .spacing = 3};
+    const auto file = dir / "ge25519-base-w5-s3.tbl";
+
+    const auto same_entries = [](const GeBaseTable& a, const GeBaseTable& b) {
+        for (size_t row = 0; row < a.Shape().Rows(); ++row) {
+            const auto lhs = std::as_bytes(a.Row(row));
+            const auto rhs = std::as_bytes(b.Row(row));
+            if (not std::ranges::equal(lhs, rhs)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const GeBaseTable reference(shape);
+    const GeBaseTable computed(shape, {.cache_dir = dir});
+    ASSERT_TRUE(computed.Origin().starts_with("computed, cached to"));
+    ASSERT_TRUE(std::filesystem::exists(file));
+
+    const GeBaseTable mapped(shape, {.cache_dir = dir});
+    ASSERT_TRUE(mapped.Origin().starts_with("mapped from"));
+    ASSERT_TRUE(same_entries(mapped, reference));
+
+    // a corrupted payload fails the checksum and is rebuilt
+    {
+        std::fstream stream(file, std::ios::in | std::ios::out |
+                                      std::ios::binary);
+        stream.seekp(200);
+        stream.put('\x5a');
+    }
+    const GeBaseTable rebuilt(shape, {.cache_dir = dir});
+    ASSERT_TRUE(rebuilt.Origin().starts_with("computed, cached to"));
+    ASSERT_TRUE(same_entries(rebuilt, reference));
+    const GeBaseTable remapped(shape, {.cache_dir = dir});
+    ASSERT_TRUE(remapped.Origin().starts_with("mapped from"));
+
+    // a forged table with a valid checksum fails the spot check
+    for (const size_t forged_entry : {size_t{1}, 3 * shape.RowSize()}) {
+        std::vector<GePrecomp> entries;
+        for (size_t row = 0; row < shape.Rows(); ++row) {
+            std::ranges::copy(reference.Row(row), std::back_inserter(entries));
+        }
+        entries[forged_entry] = entries[forged_entry + 1];
+        ASSERT_TRUE(SaveTableCache(file, "ge25519 comb w=5 s=3 r51",
+                                   std::as_bytes(std::span(entries))));
+        const GeBaseTable checked(shape, {.cache_dir = dir});
+        ASSERT_TRUE(checked.Origin().starts_with("recomputed"));
+        ASSERT_TRUE(same_entries(checked, reference));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(YggdrasilCppGetkeys, TableStoragePages)
+{
+    using yggdrasil_cpp_genkeys::HUGE_PAGE_SIZE;
+    using yggdrasil_cpp_genkeys::TableStorage;
+
+    for (const bool huge_pages : {false, true}) {
+        const size_t size = HUGE_PAGE_SIZE + 4096;
+        auto storage = TableStorage::Allocate(size, huge_pages);
+        const auto writable = storage.Writable();
+        ASSERT_EQ(writable.size(), size);
+        std::ranges::fill(writable, std::byte{0x5a});
+        if (huge_pages) {
+            // hugetlb, THP or 4 KiB, whatever the host allows
+            ASSERT_NE(storage.DescribePages(), "unknown pages");
+        }
+        else {
+            ASSERT_EQ(storage.DescribePages(), "4 KiB pages");
+        }
+
+        storage.Seal();
+        ASSERT_TRUE(storage.Writable().empty());
+        ASSERT_EQ(storage.Bytes().size(), size);
+        ASSERT_EQ(storage.Bytes().back(), std::byte{0x5a});
+    }
+}
+
+TEST(YggdrasilCppGetkeys, SeedStream)
+{
+    using yggdrasil_cpp_genkeys::SeedStream;
+
+    SeedStream stream;
+    SeedStream other;
+    ASSERT_NE(stream.Next().ToHex(), other.Next().ToHex());
+
+    // single seeds and batches across several refills never repeat
+    std::set<std::string> seen;
+    std::vector<Keys_t> batch(SeedStream::SEEDS_PER_REFILL + 3);
+    for (int round = 0; round < 3; ++round) {
+        ASSERT_TRUE(seen.insert(stream.Next().ToHex()).second);
+        stream.Fill(batch);
+        for (const auto& keys : batch) {
+            ASSERT_TRUE(seen.insert(keys.seed.ToHex()).second);
+        }
+    }
+
+    Ed25519_KeysGenerator gen;
+    gen.Generate(true);
+    const auto first = gen.Keys().seed.ToHex();
+    gen.Generate();
+    ASSERT_NE(gen.Keys().seed.ToHex(), first);
+}
+
+TEST(YggdrasilCppGetkeys, CandidateMaterialize)
+{
+    using yggdrasil_cpp_genkeys::Candidate;
+
+    // partial keys score the same as the key pairs rebuilt from their seeds
+    auto engine = yggdrasil_cpp_genkeys::MakeKeyEngine("batch", {});
+    ASSERT_NE(engine, nullptr);
+    yggdrasil_cpp_genkeys::SeedStream seeds;
+    std::vector<Keys_t> batch(64);
+    seeds.Fill(batch);
+    engine->GeneratePartial(batch);
+    for (const auto& partial : batch) {
+        Candidate candidate;
+        candidate.seed = partial.seed;
+        candidate.zero_bits = LeadingZeroBits(partial.public_key);
+
+        Ed25519_KeysGenerator gen;
+        Seed_t seed = partial.seed;
+        gen.Generate(seed);
+        const auto keys = candidate.Materialize();
+        ASSERT_EQ(keys.seed.ToHex(), partial.seed.ToHex());
+        ASSERT_EQ(keys.public_key.ToHex(), gen.Keys().public_key.ToHex());
+        ASSERT_EQ(keys.secret_key.ToHex(), gen.Keys().secret_key.ToHex());
+        ASSERT_EQ(candidate.zero_bits, LeadingZeroBits(keys.public_key));
+        ASSERT_EQ(AddrForKey(partial.public_key).ToString(),
+                  AddrForKey(keys.public_key).ToString());
+    }
+}
+
+TEST(YggdrasilCppGetkeys, ScoreThreshold)
+{
+    using yggdrasil_cpp_genkeys::Candidate;
+
+    // ranks order candidates by zero blocks, then zero bits in ipv6 mode
+    std::vector<Candidate> candidates;
+    for (uint blocks = 0; blocks < 4; ++blocks) {
+        for (uint bits : {0U, 1U, 7U, 31U, 255U}) {
+            Candidate candidate;
+            candidate.zero_bits = bits;
+            candidate.ipv6_zero_blocks = blocks;
+            candidates.push_back(candidate);
+        }
+    }
+    for (const bool ipv6_nice : {false, true}) {
+        for (const auto& a : candidates) {
+            for (const auto& b : candidates) {
+                const bool expected =
+                    ipv6_nice ? ((a.ipv6_zero_blocks > b.ipv6_zero_blocks) or
+                                 ((a.ipv6_zero_blocks == b.ipv6_zero_blocks) and
+                                  (a.zero_bits > b.zero_bits)))
+                              : (a.zero_bits > b.zero_bits);
+                ASSERT_EQ(a.IsBetter(b, ipv6_nice), expected);
+                ASSERT_EQ(a.Rank(ipv6_nice) > b.Rank(ipv6_nice), expected);
+            }
+        }
+    }
+
+    yggdrasil_cpp_genkeys::ScoreThreshold threshold;
+    ASSERT_EQ(alignof(decltype(threshold)), 64);
+    ASSERT_EQ(threshold.Load(), 0);
+    threshold.Raise(5);
+    threshold.Raise(3);
+    ASSERT_EQ(threshold.Load(), 5);
+    threshold.Raise(1ULL << 32U);
+    ASSERT_EQ(threshold.Load(), 1ULL << 32U);
+}
+
+TEST(YggdrasilCppGetkeys, MpscRing)
+{
+    yggdrasil_cpp_genkeys::MpscRing<uint64_t, 8> ring;
+    ASSERT_FALSE(ring.try_pop().has_value());
+
+    // fills up, drops and counts overflows, pops in order
+    for (uint64_t i = 0; i < 8; ++i) {
+        ASSERT_TRUE(ring.try_push(i));
+    }
+    ASSERT_FALSE(ring.try_push(8));
+    ASSERT_EQ(ring.Overflows(), 1);
+    for (uint64_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(ring.try_pop(), i);
+    }
+    ASSERT_FALSE(ring.try_pop().has_value());
+
+    // concurrent producers lose nothing when they retry
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t PER_PRODUCER = 20000;
+    std::vector<std::jthread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                while (not ring.try_push((p << 32U) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<uint64_t> next(PRODUCERS, 0);
+    for (uint64_t received = 0; received < PRODUCERS * PER_PRODUCER;) {
+        const auto value = ring.try_pop();
+        if (not value.has_value()) {
+            std::this_thread::yield();
+            continue;
+        }
+        // each producer's values arrive in the order it pushed them
+        const uint64_t p = *value >> 32U;
+        ASSERT_LT(p, PRODUCERS);
+        ASSERT_EQ(*value & 0xffffffffU, next[p]);
+        ++next[p];
+        ++received;
+    }
+    ASSERT_FALSE(ring.try_pop().has_value());
+}
+
+TEST(YggdrasilCppGetkeys, WorkerTelemetry)
+{
+    using yggdrasil_cpp_genkeys::WorkerTelemetry;
+
+    // one block per cache line, even when allocated back to back
+    std::vector<WorkerTelemetry> blocks(2);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(&blocks[0]) % 64, 0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(&blocks[1]) -
+                  reinterpret_cast<uintptr_t>(&blocks[0]),
+              64);
+
+    WorkerTelemetry::Add(blocks[0].keys_tried, 128);
+    WorkerTelemetry::Add(blocks[0].keys_tried, 128);
+    WorkerTelemetry::Add(blocks[0].candidates_pushed, 1);
+    WorkerTelemetry::Add(blocks[1].keys_tried, 64);
+    WorkerTelemetry::Add(blocks[1].threshold_rejects, 3);
+    const auto start = std::chrono::steady_clock::now() -
+                       std::chrono::microseconds(5);
+    WorkerTelemetry::AddSince(blocks[1].score_ns, start);
+
+    auto total = blocks[0].Read();
+    ASSERT_EQ(total.keys_tried, 256);
+    total += blocks[1].Read();
+    ASSERT_EQ(total.keys_tried, 320);
+    ASSERT_EQ(total.candidates_pushed, 1);
+    ASSERT_EQ(total.threshold_rejects, 3);
+    ASSERT_GE(total.score_ns, 5000);
+    ASSERT_EQ(total.seeds_ns + total.generate_ns, 0);
+}
+
+TEST(YggdrasilCppGetkeys, SpscRing)
+{
+    yggdrasil_cpp_genkeys::SpscRing<uint64_t, 4> ring;
+    ASSERT_FALSE(ring.try_pop().has_value());
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_push(i));
+    }
+    ASSERT_FALSE(ring.try_push(4));
+    ASSERT_EQ(ring.Drops(), 1);
+    ASSERT_EQ(ring.try_pop(), 0);
+    ASSERT_TRUE(ring.try_push(5));
+
+    // a concurrent producer gets everything through in order, half of it
+    // waiting in push() instead of retrying try_push()
+    constexpr uint64_t COUNT = 100000;
+    std::jthread producer([&ring] {
+        for (uint64_t i = 6; i < COUNT; ++i) {
+            if (i % 2 == 0) {
+                ring.push(i);
+                continue;
+            }
+            while (not ring.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::vector<uint64_t> expected = {1, 2, 3, 5};
+    for (uint64_t i = 6; i < COUNT; ++i) {
+        expected.push_back(i);
+    }
+    for (const uint64_t value : expected) {
+        std::optional<uint64_t> popped;
+        while (not(popped = ring.try_pop()).has_value()) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(*popped, value);
+    }
+}
+
+TEST(YggdrasilCppGetkeys, LogPrinterFormat)
+{
+    using yggdrasil_cpp_genkeys::LogFormat;
+    using yggdrasil_cpp_genkeys::LogPrinter;
+    using yggdrasil_cpp_genkeys::LogRecord;
+
+    ASSERT_EQ(yggdrasil_cpp_genkeys::ParseLogFormat("json"), LogFormat::Json);
+    ASSERT_FALSE(yggdrasil_cpp_genkeys::ParseLogFormat("xml").has_value());
+
+    Ed25519_KeysGenerator gen;
+    gen.Generate(true);
+    const auto pub = gen.Keys().public_key.ToHex();
+    const auto addr = AddrForKey(gen.Keys().public_key).ToString();
+
+    LogRecord record;
+    record.thread = 7;
+    record.candidate.seed = gen.Keys().seed;
+    record.candidate.zero_bits = LeadingZeroBits(gen.Keys().public_key);
+    ASSERT_EQ(LogPrinter::Format(record, LogFormat::Text, true),
+              std::format("    thread {:3}: new best z={:2} | pub={} | ip={}",
+                          7, record.candidate.zero_bits, pub, addr));
+    ASSERT_EQ(LogPrinter::Format(record, LogFormat::Json, true),
+              std::format(R"({{"event":"new_best","thread":7,)"
+                          R"("zero_bits":{},"ipv6_zero_blocks":0,)"
+                          R"("public_key":"{}","address":"{}"}})",
+                          record.candidate.zero_bits, pub, addr));
+
+    record.kind = LogRecord::Kind::Result;
+    record.elapsed_ns = 2'500'000'000;
+    record.telemetry.keys_tried = 5000;
+    const auto text = LogPrinter::Format(record, LogFormat::Text, false);
+    ASSERT_TRUE(text.starts_with("----- 2.5s --- 5000 keys tried\n"));
+    ASSERT_TRUE(text.ends_with(
+        std::format("Priv: {}\nPub: {}\nIP: {}",
+                    gen.Keys().secret_key.ToHex(), pub, addr)));
+    const auto json = LogPrinter::Format(record, LogFormat::Json, false);
+    ASSERT_TRUE(json.starts_with(
+        R"({"event":"best","elapsed_seconds":2.500,"keys_tried":5000,)"
+        R"("keys_per_second":2000,)"));
+    ASSERT_TRUE(json.ends_with(std::format(R"("address":"{}"}})", addr)));
+    ASSERT_EQ(json.find(R"("target")"), std::string::npos);
+
+    record.candidate.pattern_match = true;
+    record.candidate.target = 12;
+    ASSERT_NE(LogPrinter::Format(record, LogFormat::Json, false)
+                  .find(R"("ipv6_zero_blocks":0,"target":12,"private_key")"),
+              std::string::npos);
+}
+
+TEST(YggdrasilCppGetkeys, ScoringPolicies)
+{
+    using yggdrasil_cpp_genkeys::Ipv6NiceScoring;
+    using yggdrasil_cpp_genkeys::LeadingZerosScoring;
+
+    Ed25519_KeysGenerator gen;
+    gen.Generate(true);
+    for (int i = 0; i < 256; ++i) {
+        gen.Generate();
+        const auto& key = gen.Keys().public_key;
+        const auto zeros = LeadingZerosScoring::Score(key);
+        const auto nice = Ipv6NiceScoring::Score(key);
+        ASSERT_EQ(zeros.zero_bits, LeadingZeroBits(key));
+        ASSERT_EQ(zeros.ipv6_zero_blocks, 0);
+        ASSERT_EQ(nice.zero_bits, LeadingZeroBits(key));
+        ASSERT_EQ(nice.ipv6_zero_blocks, AddressZeroBlocks(AddrForKey(key)));
+        ASSERT_EQ(LeadingZerosScoring::Rank(zeros), zeros.Rank(false));
+        ASSERT_EQ(Ipv6NiceScoring::Rank(nice), nice.Rank(true));
+    }
+}
+
+TEST(YggdrasilCppGetkeys, ScoreBatchMasks)
+{
+    using yggdrasil_cpp_genkeys::Ipv6NiceScoring;
+    using yggdrasil_cpp_genkeys::KeyBlock;
+    using yggdrasil_cpp_genkeys::LeadingZerosScoring;
+    using yggdrasil_cpp_genkeys::SCORE_BLOCK;
+    using yggdrasil_cpp_genkeys::ScoreMask;
+
+    // arbitrary byte strings, many with leading zeros and runs of ones
+    std::vector<Keys_t> keys(SCORE_BLOCK * 64);
+    std::vector<uint8_t> random(keys.size() * PublicKey_t::Size);
+    randombytes_buf(random.data(), random.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto& bytes = keys[i].public_key.bytes;
+        std::copy_n(random.begin() + (i * bytes.size()), bytes.size(),
+                    bytes.begin());
+        const size_t zeros = i % 11;  // whole zero bytes, 8 and more: w0 = 0
+        std::fill_n(bytes.begin(), zeros, 0);
+        if (i % 3 != 0) {
+            // ones across where the address groups start
+            std::fill_n(bytes.begin() + zeros + 1, (i / 3) % 12, 0xff);
+        }
+    }
+
+    const bool avx2 = yggdrasil_cpp_genkeys::GetCpuFeatures().avx2;
+    uint max_blocks = 0;
+    KeyBlock block;
+    for (size_t first = 0; first < keys.size(); first += SCORE_BLOCK) {
+        const auto span = std::span<const Keys_t>(keys).subspan(first);
+        yggdrasil_cpp_genkeys::LoadKeyBlock(span.first<SCORE_BLOCK>(), block);
+
+        std::array<uint64_t, SCORE_BLOCK> zeros_rank{};
+        std::array<uint64_t, SCORE_BLOCK> nice_rank{};
+        ScoreMask unresolved = 0;  // 64 or more leading zero bits
+        for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+            const auto& key = span[i].public_key;
+            const auto nice = Ipv6NiceScoring::Score(key);
+            zeros_rank[i] =
+                LeadingZerosScoring::Rank(LeadingZerosScoring::Score(key));
+            nice_rank[i] = Ipv6NiceScoring::Rank(nice);
+            max_blocks = std::max(max_blocks, nice.ipv6_zero_blocks);
+            unresolved |= static_cast<ScoreMask>(nice.zero_bits >= 64) << i;
+        }
+
+        for (const uint64_t bits : {0U, 1U, 7U, 8U, 20U, 62U, 63U, 64U, 90U}) {
+            for (const uint64_t blocks : {0U, 1U, 2U, 3U}) {
+                const uint64_t rank = (blocks << 32U) | bits;
+                ScoreMask zeros_expected = 0;
+                ScoreMask nice_expected = 0;
+                for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+                    zeros_expected |=
+                        static_cast<ScoreMask>(zeros_rank[i] > bits) << i;
+                    nice_expected |=
+                        static_cast<ScoreMask>(nice_rank[i] > rank) << i;
+                }
+                // exact, except that unresolved keys are always included
+                for (const bool simd : {false, avx2}) {
+                    ASSERT_EQ(LeadingZerosScoring::Mask(block, bits, simd),
+                              zeros_expected | unresolved);
+                    ASSERT_EQ(Ipv6NiceScoring::Mask(block, rank, simd),
+                              nice_expected | unresolved);
+                }
+            }
+        }
+    }
+    ASSERT_GE(max_blocks, 2);
+}
+
+TEST(YggdrasilCppGetkeys, AddressPattern)
+{
+    using yggdrasil_cpp_genkeys::AddressPattern;
+    using yggdrasil_cpp_genkeys::AddrForKey;
+    using yggdrasil_cpp_genkeys::KeyBlock;
+    using yggdrasil_cpp_genkeys::PatternScoring;
+    using yggdrasil_cpp_genkeys::SCORE_BLOCK;
+    using yggdrasil_cpp_genkeys::ScoreMask;
+
+    const auto pattern = AddressPattern::Parse("200:dead:BEEF:*");
+    ASSERT_TRUE(pattern.has_value());
+    ASSERT_EQ(pattern->mask[0], 0xffffffffffff0000ULL);
+    ASSERT_EQ(pattern->value[0], 0x0200deadbeef0000ULL);
+    ASSERT_EQ(pattern->mask[1], 0);
+    ASSERT_EQ(AddressPattern::Parse("200:dead:beef:*:*:*:*:*")->mask,
+              pattern->mask);
+
+    const auto nibbles = AddressPattern::Parse("2?0:*:1:*:*:*:*:a?c");
+    ASSERT_TRUE(nibbles.has_value());
+    ASSERT_EQ(nibbles->mask[0], 0xff0f0000ffff0000ULL);
+    ASSERT_EQ(nibbles->value[0], 0x0200000000010000ULL);
+    ASSERT_EQ(nibbles->mask[1], 0x000000000000ff0fULL);
+    ASSERT_EQ(nibbles->value[1], 0x0000000000000a0cULL);
+    ASSERT_TRUE(nibbles->MatchesLeadingZeros(0x30));
+    ASSERT_FALSE(nibbles->MatchesLeadingZeros(0x31));
+
+    for (const auto* bad : {"", "*:", "200", "200:dead", "300:*", "200::1:*",
+                            "200:12345:*", "200:xyz:*", "1:2:3:4:5:6:7:8:9",
+                            "200:1:2:3:4:5:6:7:"}) {
+        ASSERT_FALSE(AddressPattern::Parse(bad).has_value()) << bad;
+    }
+
+    // every address matches its own text, and only it
+    for (const auto& sample : test_data) {
+        PublicKey_t key;
+        key.FromHex(sample.public_hex);
+        const auto addr = AddrForKey(key);
+        const auto exact = AddressPattern::Parse(sample.ipv6_hex);
+        ASSERT_TRUE(exact.has_value()) << sample.ipv6_hex;
+        ASSERT_TRUE(exact->Matches(addr));
+        for (const auto& other : test_data) {
+            if (other.public_hex != sample.public_hex) {
+                PublicKey_t other_key;
+                other_key.FromHex(other.public_hex);
+                ASSERT_FALSE(exact->Matches(AddrForKey(other_key)));
+            }
+        }
+    }
+
+    // the block filter includes exactly the matches that rank higher
+    const PatternScoring scoring{.pattern =
+                                     *AddressPattern::Parse("20?:??:*")};
+    std::vector<Keys_t> keys(SCORE_BLOCK * 256);
+    std::vector<uint8_t> random(keys.size() * PublicKey_t::Size);
+    randombytes_buf(random.data(), random.size());
+    size_t matches = 0;
+    KeyBlock block;
+    for (size_t first = 0; first < keys.size(); first += SCORE_BLOCK) {
+        for (size_t i = first; i < first + SCORE_BLOCK; ++i) {
+            auto& bytes = keys[i].public_key.bytes;
+            std::copy_n(random.begin() + (i * bytes.size()), bytes.size(),
+                        bytes.begin());
+            // some with 8 or more zero bytes: w0 = 0
+            std::fill_n(bytes.begin(), (i % 5 == 0) ? i % 10 : 0, 0);
+        }
+        const auto span = std::span<const Keys_t>(keys).subspan(first);
+        yggdrasil_cpp_genkeys::LoadKeyBlock(span.first<SCORE_BLOCK>(), block);
+        for (const uint64_t rank : {uint64_t{0}, PatternScoring::MATCH,
+                                    PatternScoring::MATCH | 3U}) {
+            ScoreMask expected = 0;
+            for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+                const auto& key = span[i].public_key;
+                const auto score = scoring.Score(key);
+                ASSERT_EQ(score.pattern_match,
+                          scoring.pattern.Matches(AddrForKey(key)));
+                const bool unresolved = (score.zero_bits >= 64);
+                expected |= static_cast<ScoreMask>(
+                                unresolved or
+                                (PatternScoring::Rank(score) > rank))
+                            << i;
+                matches += static_cast<size_t>(score.pattern_match);
+            }
+            ASSERT_EQ(scoring.Mask(block, rank, false), expected);
+        }
+    }
+    ASSERT_GT(matches, 0);
+}
+
+TEST(YggdrasilCppGetkeys, PatternSet)
+{
+    using yggdrasil_cpp_genkeys::AddressPattern;
+    using yggdrasil_cpp_genkeys::AddrForKey;
+    using yggdrasil_cpp_genkeys::KeyBlock;
+    using yggdrasil_cpp_genkeys::LoadBigEndian64;
+    using yggdrasil_cpp_genkeys::MultiPatternScoring;
+    using yggdrasil_cpp_genkeys::PatternSet;
+    using yggdrasil_cpp_genkeys::ReadPatterns;
+    using yggdrasil_cpp_genkeys::SCORE_BLOCK;
+    using yggdrasil_cpp_genkeys::ScoreMask;
+
+    size_t bad_line = 0;
+    std::istringstream file("# targets\n\n  200:dead:*\r\n2??:?:*\n");
+    const auto read = ReadPatterns(file, bad_line);
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(read->size(), 2);
+    ASSERT_EQ(bad_line, 0);
+    std::istringstream bad("200:dead:*\n\n200:nope:*\n");
+    ASSERT_FALSE(ReadPatterns(bad, bad_line).has_value());
+    ASSERT_EQ(bad_line, 3);
+
+    // random addresses, many sharing prefixes with the targets
+    constexpr size_t ADDRESSES = 20000;
+    std::vector<uint64_t> random(2 * ADDRESSES);
+    randombytes_buf(random.data(), random.size() * sizeof(uint64_t));
+    std::vector<std::array<uint64_t, 2>> addresses(ADDRESSES);
+    for (size_t i = 0; i < ADDRESSES; ++i) {
+        // 02, ones below 4, group 1 below 16
+        addresses[i] = {(uint64_t{0x02} << 56U) |
+                            (random[2 * i] & 0x0003000fffffffffULL),
+                        random[(2 * i) + 1]};
+    }
+
+    // indexed targets built from some of the addresses, a few unindexed
+    std::vector<AddressPattern> patterns;
+    for (size_t i = 0; i < 2000; ++i) {
+        const auto& addr = addresses[i * 7];
+        AddressPattern pattern;
+        pattern.mask = {0xffffffffff000000ULL, 0};
+        pattern.value = {addr[0] & pattern.mask[0], 0};
+        patterns.push_back(pattern);
+    }
+    patterns.push_back(*AddressPattern::Parse("2?1:?:*"));
+    patterns.push_back(*AddressPattern::Parse("*:*:*:*:*:*:*:?abc"));
+    const PatternSet set(patterns);
+    ASSERT_EQ(set.Size(), patterns.size());
+
+    size_t matched = 0;
+    for (const auto& addr : addresses) {
+        std::vector<uint32_t> expected;
+        for (uint32_t t = 0; t < patterns.size(); ++t) {
+            if (patterns[t].Matches(addr[0], addr[1])) {
+                expected.push_back(t);
+            }
+        }
+        std::vector<uint32_t> found;
+        set.ForEachMatch(addr[0], addr[1],
+                         [&found](uint32_t t) { found.push_back(t); });
+        std::ranges::sort(found);
+        ASSERT_EQ(found, expected);
+        ASSERT_EQ(set.AnyMatch(addr[0], addr[1]), not expected.empty());
+        matched += static_cast<size_t>(not expected.empty());
+    }
+    ASSERT_GE(matched, 2000);
+
+    // every target keeps its own best; the block filter lets all matches in
+    auto targets = std::make_shared<const PatternSet>(
+        std::vector<AddressPattern>{*AddressPattern::Parse("20?:*"),
+                                    *AddressPattern::Parse("201:*"),
+                                    *AddressPattern::Parse("*:*:*:*:*:*:*:???0")});
+    MultiPatternScoring scoring(targets);
+    std::vector<Keys_t> keys(SCORE_BLOCK * 64);
+    std::vector<uint8_t> bytes(keys.size() * PublicKey_t::Size);
+    randombytes_buf(bytes.data(), bytes.size());
+    std::array<uint64_t, 3> best{};
+    KeyBlock block;
+    for (size_t first = 0; first < keys.size(); first += SCORE_BLOCK) {
+        for (size_t i = first; i < first + SCORE_BLOCK; ++i) {
+            auto& key = keys[i].public_key.bytes;
+            std::copy_n(bytes.begin() + (i * key.size()), key.size(),
+                        key.begin());
+            key[0] &= 0x7f >> (i % 4);  // some leading zero bits
+        }
+        const auto span = std::span<const Keys_t>(keys).subspan(first);
+        yggdrasil_cpp_genkeys::LoadKeyBlock(span.first<SCORE_BLOCK>(), block);
+        const ScoreMask mask = scoring.Mask(block, 0, false);
+        for (size_t i = 0; i < SCORE_BLOCK; ++i) {
+            const auto& key = span[i].public_key;
+            const auto addr = AddrForKey(key);
+            const uint64_t hi = LoadBigEndian64(addr.bytes.data());
+            const uint64_t lo = LoadBigEndian64(addr.bytes.data() + 8);
+            ASSERT_EQ(((mask >> i) & 1U) != 0, targets->AnyMatch(hi, lo));
+
+            std::array<bool, 3> improves{};
+            for (uint32_t t = 0; t < 3; ++t) {
+                const uint64_t rank =
+                    MultiPatternScoring::Rank({.zero_bits = LeadingZeroBits(key),
+                                               .target = t,
+                                               .pattern_match = true});
+                improves[t] = (*targets)[t].Matches(hi, lo) and (rank > best[t]);
+                if (improves[t]) {
+                    best[t] = rank;
+                }
+            }
+            std::array<bool, 3> reported{};
+            scoring.ForEachImproved(key, [&](const auto& score) {
+                ASSERT_TRUE(score.pattern_match);
+                reported[score.target] = true;
+            });
+            ASSERT_EQ(reported, improves);
+        }
+    }
+    ASSERT_EQ(scoring.ranks, std::vector<uint64_t>(best.begin(), best.end()));
+    ASSERT_TRUE(std::ranges::none_of(best, [](uint64_t b) { return b == 0; }));
+}
+
+TEST(YggdrasilCppGetkeys, WorkerFullQueue)
+{
+    using yggdrasil_cpp_genkeys::AddressPattern;
+    using yggdrasil_cpp_genkeys::AddrForKey;
+    using yggdrasil_cpp_genkeys::Candidate;
+    using yggdrasil_cpp_genkeys::CandidateRing;
+    using yggdrasil_cpp_genkeys::MultiPatternScoring;
+    using yggdrasil_cpp_genkeys::PatternSet;
+    using yggdrasil_cpp_genkeys::Worker;
+
+    // second address byte 0..3, so each template matches every 2nd to 16th
+    // key and all of them improve within a few batches
+    auto targets = std::make_shared<const PatternSet>(
+        std::vector<AddressPattern>{
+            *AddressPattern::Parse("200:*"), *AddressPattern::Parse("201:*"),
+            *AddressPattern::Parse("202:*"), *AddressPattern::Parse("203:*")});
+    yggdrasil_cpp_genkeys::Settings settings;
+    settings.engine = "batch";
+    CandidateRing queue;
+    while (queue.try_push(Candidate{})) {
+    }
+    yggdrasil_cpp_genkeys::ScoreThreshold threshold;
+    yggdrasil_cpp_genkeys::Wakeup wakeup{0};
+    yggdrasil_cpp_genkeys::LogPrinter printer(
+        1, yggdrasil_cpp_genkeys::LogFormat::Text, false);
+    yggdrasil_cpp_genkeys::ScoredWorker<MultiPatternScoring> worker(
+        settings, 0, &queue, &threshold, &wakeup, printer.RingFor(0),
+        MultiPatternScoring(targets));
+
+    const auto run_batches = [&worker](uint64_t batches) {
+        const uint64_t until = worker.Telemetry().Read().keys_tried +
+                               (batches * Worker::BATCH_SIZE);
+        std::jthread thread(std::bind_front(&Worker::Process, &worker));
+        while (worker.Telemetry().Read().keys_tried < until) {
+            std::this_thread::yield();
+        }
+    };
+
+    // with the queue full, the best of every template waits in the worker
+    run_batches(16);
+    ASSERT_TRUE(worker.Finished());
+    std::set<uint32_t> waiting;
+    for (const auto& candidate : worker.Unsent()) {
+        ASSERT_TRUE(candidate.pattern_match);
+        auto keys = candidate.Materialize();
+        ASSERT_TRUE((*targets)[candidate.target].Matches(
+            AddrForKey(keys.public_key)));
+        sodium_memzero(&keys, sizeof(keys));
+        waiting.insert(candidate.target);
+    }
+    ASSERT_EQ(waiting.size(), targets->Size());
+    ASSERT_EQ(worker.Unsent().size(), targets->Size());
+
+    // once there is room, all of them reach the queue after the next batch
+    while (queue.try_pop().has_value()) {
+    }
+    run_batches(1);
+    ASSERT_TRUE(worker.Unsent().empty());
+    std::set<uint32_t> queued;
+    while (const auto candidate = queue.try_pop()) {
+        queued.insert(candidate->target);
+    }
+    ASSERT_EQ(queued, waiting);
+}
+
+TEST(YggdrasilCppGetkeys, AddrForKeyWords)
+{
+    using yggdrasil_cpp_genkeys::AddrForKey;
+
+    // usable in constant expressions
+    constexpr auto addr = AddrForKey([] {
+        PublicKey_t key{};
+        key.bytes[1] = 0x5a;  // inverted: 8 + 1 ones, a zero, then 100101
+        return key;
+    }());
+    static_assert(addr.bytes[1] == 9);
+    static_assert(addr.bytes[2] == 0x97);
+    static_assert(addr.bytes[3] == 0xff);
+    static_assert(addr.bytes[15] == 0xff);
+
+    // every leading zero count the address can encode, at every shift,
+    // with random bits after the first one bit
+    std::array<uint8_t, PublicKey_t::Size> random{};
+    for (size_t zeros = 0; zeros < 128; ++zeros) {
+        for (size_t round = 0; round < 64; ++round) {
+            randombytes_buf(random.data(), random.size());
+            PublicKey_t key;
+            key.bytes = random;
+            for (size_t bit = 0; bit <= zeros; ++bit) {
+                const auto mask = static_cast<uint8_t>(0x80U >> (bit % 8));
+                if (bit == zeros) {
+                    key.bytes[bit / 8] |= mask;
+                }
+                else {
+                    key.bytes[bit / 8] &= ~mask;
+                }
+            }
+            ASSERT_EQ(AddrForKey(key).bytes, ReferenceAddrForKey(key).bytes)
+                << key.ToHex();
+        }
+    }
+
+    // no one bit at all
+    const PublicKey_t zero{};
+    ASSERT_EQ(AddrForKey(zero).bytes, ReferenceAddrForKey(zero).bytes);
+
+    for (const auto& sample : test_data) {
+        PublicKey_t key;
+        key.FromHex(sample.public_hex);
+        ASSERT_EQ(AddrForKey(key).ToString(), sample.ipv6_hex);
+    }
+}
+
+TEST(YggdrasilCppGetkeys, Sha512SeedHasher)
+{
+    yggdrasil_cpp_genkeys::Sha512SeedHasher hasher;
+    Seed_t seed;
+    randombytes_buf(seed.data(), seed.size());
+    // run the increment across a carry into the upper seed words
+    std::fill(seed.bytes.begin() + 20, seed.bytes.end(), 0xFF);
+    seed.bytes[31] = 0xF0;
+
+    for (int i = 0; i < 64; ++i) {
+        Sha512Digest digest{};
+        Sha512Digest expected{};
+        hasher.Hash(seed, digest);
+        crypto_hash_sha512(expected.data(), seed.data(), seed.size());
+        ASSERT_EQ(digest, expected);
+        ++seed;
+    }
+
+    randombytes_buf(seed.data(), seed.size());
+    Sha512Digest digest{};
+    Sha512Digest expected{};
+    hasher.Hash(seed, digest);
+    crypto_hash_sha512(expected.data(), seed.data(), seed.size());
+    ASSERT_EQ(digest, expected);
+}
+
+TEST(YggdrasilCppGetkeys, Sha512SeedsX4)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (!yggdrasil_cpp_genkeys::GetCpuFeatures().avx2) {
+        GTEST_SKIP() << "AVX2 is not supported by this CPU";
+    }
+
+    constexpr size_t LANES = yggdrasil_cpp_genkeys::SHA512_X4_LANES;
+    for (int round = 0; round < 16; ++round) {
+        std::array<Seed_t, LANES> seeds{};
+        std::array<Sha512Digest, LANES> digests{};
+        std::array<const Seed_t*, LANES> seed_ptrs{};
+        std::array<Sha512Digest*, LANES> digest_ptrs{};
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            randombytes_buf(seeds[lane].data(), seeds[lane].size());
+            seed_ptrs[lane] = &seeds[lane];
+            digest_ptrs[lane] = &digests[lane];
+        }
+
+        yggdrasil_cpp_genkeys::Sha512SeedsX4(seed_ptrs, digest_ptrs);
+
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            Sha512Digest expected{};
+            crypto_hash_sha512(expected.data(), seeds[lane].data(),
+                               seeds[lane].size());
+            ASSERT_EQ(digests[lane], expected);
+        }
+    }
+#else
+    GTEST_SKIP() << "AVX2 kernels are x86 only";
+#endif
+}
+
 TEST(YggdrasilCppGetkeys, Hex)
 {
     const std::array<uint8_t, 7> bytes = {0x12, 0x34, 0x56, 0x78,